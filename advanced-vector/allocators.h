@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "vector.h"
+
+// Аллокатор поверх malloc/free. В отличие от std::allocator поддерживает reallocate, поэтому
+// Vector с тривиально перемещаемыми элементами растёт через realloc без копирования всего буфера.
+// Крупные блоки glibc выделяет через mmap и расширяет через mremap, не трогая их содержимое
+template<typename T>
+class MallocAllocator {
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	static_assert(alignof(T) <= alignof(std::max_align_t), "malloc cannot satisfy alignment of T");
+
+	MallocAllocator() = default;
+
+	template<typename U>
+	MallocAllocator(const MallocAllocator<U>&) noexcept {
+	}
+
+	T* allocate(size_t n) {
+		return static_cast<T*>(CheckedResult(std::malloc(ByteCount(n))));
+	}
+
+	void deallocate(T *p, size_t) noexcept {
+		std::free(p);
+	}
+
+	// Изменяет размер блока p с old_n до new_n элементов. При неудаче исходный блок остаётся действительным
+	T* reallocate(T *p, size_t, size_t new_n) {
+		return static_cast<T*>(CheckedResult(std::realloc(static_cast<void*>(p), ByteCount(new_n))));
+	}
+
+#if defined(__GLIBC__)
+	// Фактический размер блока: malloc округляет запрос до своего класса размеров, и хвост блока
+	// становится частью ёмкости вектора
+	size_t usable_size(T *p, size_t) const noexcept {
+		return malloc_usable_size(p) / sizeof(T);
+	}
+#endif
+
+	template<typename U>
+	bool operator==(const MallocAllocator<U>&) const noexcept {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const MallocAllocator<U>&) const noexcept {
+		return false;
+	}
+
+private:
+	static size_t ByteCount(size_t n) {
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+		return n * sizeof(T);
+	}
+
+	static void* CheckedResult(void *p) {
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+};
+
+// Аллокатор, выравнивающий буфер по границе Alignment байт (например, 32 или 64 для SIMD-загрузок
+// и кэш-линий). Если HugePageThreshold не равен нулю, блоки от этого размера выравниваются по huge page,
+// а в Linux для них дополнительно запрашиваются прозрачные huge pages, что уменьшает промахи TLB
+template<typename T, size_t Alignment = 64, size_t HugePageThreshold = 0>
+class AlignedAllocator {
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	static constexpr size_t kAlignment = std::max(Alignment, alignof(T));
+	static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+	static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+	template<typename U>
+	struct rebind {
+		using other = AlignedAllocator<U, Alignment, HugePageThreshold>;
+	};
+
+	AlignedAllocator() = default;
+
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment, HugePageThreshold>&) noexcept {
+	}
+
+	T* allocate(size_t n) {
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+		size_t bytes = n * sizeof(T);
+		if (IsHuge(bytes)) {
+			bytes = RoundToHugePage(bytes);
+			void *p = operator new(bytes, std::align_val_t(kHugePageSize));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+			madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+			return static_cast<T*>(p);
+		}
+		return static_cast<T*>(operator new(bytes, std::align_val_t(kAlignment)));
+	}
+
+	void deallocate(T *p, size_t n) noexcept {
+		size_t bytes = n * sizeof(T);
+		if (IsHuge(bytes)) {
+			operator delete(p, RoundToHugePage(bytes), std::align_val_t(kHugePageSize));
+		} else {
+			operator delete(p, bytes, std::align_val_t(kAlignment));
+		}
+	}
+
+	template<typename U>
+	bool operator==(const AlignedAllocator<U, Alignment, HugePageThreshold>&) const noexcept {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment, HugePageThreshold>&) const noexcept {
+		return false;
+	}
+
+private:
+	static bool IsHuge(size_t bytes) noexcept {
+		return HugePageThreshold != 0 && bytes >= HugePageThreshold;
+	}
+
+	static size_t RoundToHugePage(size_t bytes) noexcept {
+		return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+	}
+};
+
+// Vector, чей буфер выровнен по границе Alignment байт
+template<typename T, size_t Alignment = 64>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>>;
+
+// Аллокатор вектора, получившего чужой буфер (malloc, mmap, память другой библиотеки). Этот буфер
+// освобождается вызовом deleter(buffer, capacity), а буферы, выделенные при росте, берутся у std::allocator.
+// Копии аллокатора разделяют общее состояние, поэтому любая из них правильно освободит чужой буфер
+template<typename T, typename Deleter = void(*)(T*, size_t)>
+class AdoptingAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	AdoptingAllocator() = default;
+
+	AdoptingAllocator(T *adopted, Deleter deleter) :
+			state_(std::make_shared<State>(adopted, std::move(deleter))) {
+	}
+
+	T* allocate(size_t n) {
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T *p, size_t n) noexcept {
+		if (state_ != nullptr && p != nullptr && state_->adopted.load(std::memory_order_acquire) == p) {
+			state_->adopted.store(nullptr, std::memory_order_release);
+			state_->deleter(p, n);
+		} else {
+			std::allocator<T>().deallocate(p, n);
+		}
+	}
+
+	bool operator==(const AdoptingAllocator &other) const noexcept {
+		return state_ == other.state_;
+	}
+
+	bool operator!=(const AdoptingAllocator &other) const noexcept {
+		return state_ != other.state_;
+	}
+
+private:
+	struct State {
+		State(T *adopted, Deleter deleter) :
+				adopted(adopted), deleter(std::move(deleter)) {
+		}
+
+		std::atomic<T*> adopted;
+		Deleter deleter;
+	};
+
+	std::shared_ptr<State> state_;
+};
+
+// Vector, способный принять чужой буфер через Adopt(buffer, size, capacity, deleter)
+template<typename T, typename Deleter = void(*)(T*, size_t)>
+using AdoptingVector = Vector<T, AdoptingAllocator<T, Deleter>>;
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "vector.h"
+
+// Монотонная арена: память выделяется сдвигом указателя внутри крупных блоков и по отдельности
+// не освобождается. Reset() разом освобождает всё, что было выделено, оставляя последний блок для повторного
+// использования. Арена не потокобезопасна и предназначена для объектов одного запроса
+class MonotonicArena {
+public:
+	explicit MonotonicArena(size_t initial_block_size = 4096) noexcept :
+			next_block_size_(std::max(initial_block_size, sizeof(Block) * 2)) {
+	}
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+	~MonotonicArena() {
+		ReleaseBlocks(nullptr);
+	}
+
+	void* Allocate(size_t bytes, size_t alignment) {
+		char *result = AlignUp(current_, alignment);
+		if (current_ == nullptr || result > end_ || bytes > static_cast<size_t>(end_ - result)) {
+			AddBlock(bytes + alignment);
+			result = AlignUp(current_, alignment);
+		}
+		current_ = result + bytes;
+		return result;
+	}
+
+	// Меняет размер блока p с old_bytes до new_bytes без перемещения. Это возможно, только если p —
+	// последнее выделение арены и в текущем блоке хватает места
+	bool TryResize(void *p, size_t old_bytes, size_t new_bytes) noexcept {
+		char *block = static_cast<char*>(p);
+		if (block + old_bytes != current_ || new_bytes > static_cast<size_t>(end_ - block)) {
+			return false;
+		}
+		current_ = block + new_bytes;
+		return true;
+	}
+
+	// Освобождает всю выделенную память. Все указатели, полученные от арены, становятся недействительными
+	void Reset() noexcept {
+		if (head_ == nullptr) {
+			return;
+		}
+		ReleaseBlocks(head_);
+		current_ = reinterpret_cast<char*>(head_ + 1);
+	}
+
+	// Общий размер блоков, запрошенных у системы
+	size_t ReservedBytes() const noexcept {
+		size_t total = 0;
+		for (const Block *block = head_; block != nullptr; block = block->next) {
+			total += block->size;
+		}
+		return total;
+	}
+
+private:
+	// Заголовок блока; память под выделения начинается сразу за ним
+	struct alignas(std::max_align_t) Block {
+		Block *next;
+		size_t size;
+	};
+
+	static char* AlignUp(char *p, size_t alignment) noexcept {
+		auto address = reinterpret_cast<std::uintptr_t>(p);
+		return reinterpret_cast<char*>((address + alignment - 1) & ~(std::uintptr_t(alignment) - 1));
+	}
+
+	void AddBlock(size_t min_bytes) {
+		size_t size = std::max(next_block_size_, min_bytes + sizeof(Block));
+		auto *block = static_cast<Block*>(operator new(size));
+		block->next = head_;
+		block->size = size;
+		head_ = block;
+		current_ = reinterpret_cast<char*>(block + 1);
+		end_ = reinterpret_cast<char*>(block) + size;
+		next_block_size_ = size * 2;
+	}
+
+	// Освобождает все блоки, кроме keep (он остаётся единственным)
+	void ReleaseBlocks(Block *keep) noexcept {
+		Block *block = head_;
+		while (block != nullptr) {
+			Block *next = block->next;
+			if (block != keep) {
+				operator delete(block);
+			}
+			block = next;
+		}
+		head_ = keep;
+		if (keep != nullptr) {
+			keep->next = nullptr;
+		}
+	}
+
+	Block *head_ = nullptr;
+	char *current_ = nullptr;
+	char *end_ = nullptr;
+	size_t next_block_size_;
+};
+
+// Аллокатор, берущий память из MonotonicArena. deallocate ничего не делает, а reallocate расширяет
+// последний выделенный блок на месте, поэтому растущий вектор не оставляет за собой старых буферов
+template<typename T>
+class ArenaAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	explicit ArenaAllocator(MonotonicArena &arena) noexcept :
+			arena_(&arena) {
+	}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) noexcept :
+			arena_(&other.GetArena()) {
+	}
+
+	T* allocate(size_t n) {
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+		return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, size_t) noexcept {
+	}
+
+	T* reallocate(T *p, size_t old_n, size_t new_n) {
+		if (arena_->TryResize(p, old_n * sizeof(T), new_n * sizeof(T))) {
+			return p;
+		}
+		// Старый блок остаётся в арене до её сброса
+		T *result = allocate(new_n);
+		std::memcpy(static_cast<void*>(result), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+		return result;
+	}
+
+	MonotonicArena& GetArena() const noexcept {
+		return *arena_;
+	}
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U> &other) const noexcept {
+		return arena_ == &other.GetArena();
+	}
+
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U> &other) const noexcept {
+		return !(*this == other);
+	}
+
+private:
+	MonotonicArena *arena_;
+};
+
+// Vector, живущий в арене
+template<typename T>
+using ArenaVector = Vector<T, ArenaAllocator<T>>;
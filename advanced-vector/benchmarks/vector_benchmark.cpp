@@ -0,0 +1,329 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bit_vector.h"
+#include "flat_map.h"
+#include "vector.h"
+#include "vector_algorithms.h"
+
+namespace {
+
+// Тип с конструктором перемещения без noexcept: при реаллокации Vector вынужден копировать элементы
+struct ThrowingMove {
+	ThrowingMove() = default;
+	explicit ThrowingMove(std::string value) :
+			value(std::move(value)) {
+	}
+	ThrowingMove(const ThrowingMove&) = default;
+	ThrowingMove(ThrowingMove &&other) :
+			value(std::move(other.value)) {
+	}
+	ThrowingMove& operator=(const ThrowingMove&) = default;
+	ThrowingMove& operator=(ThrowingMove&&) = default;
+
+	std::string value;
+};
+
+template<typename T>
+T MakeValue(size_t i);
+
+template<>
+int MakeValue<int>(size_t i) {
+	return static_cast<int>(i);
+}
+
+template<>
+std::string MakeValue<std::string>(size_t i) {
+	// Строка длиннее буфера SSO, чтобы перемещение отличалось от копирования
+	return "benchmark value that does not fit SSO #" + std::to_string(i);
+}
+
+template<>
+ThrowingMove MakeValue<ThrowingMove>(size_t i) {
+	return ThrowingMove(MakeValue<std::string>(i));
+}
+
+// Единый интерфейс к Vector и std::vector, чтобы один и тот же бенчмарк работал с обоими
+
+template<typename T>
+void PushBack(Vector<T> &v, const T &value) {
+	v.PushBack(value);
+}
+template<typename T>
+void PushBack(std::vector<T> &v, const T &value) {
+	v.push_back(value);
+}
+
+template<typename T>
+void EmplaceBack(Vector<T> &v, T &&value) {
+	v.EmplaceBack(std::move(value));
+}
+template<typename T>
+void EmplaceBack(std::vector<T> &v, T &&value) {
+	v.emplace_back(std::move(value));
+}
+
+template<typename T>
+void Reserve(Vector<T> &v, size_t capacity) {
+	v.Reserve(capacity);
+}
+template<typename T>
+void Reserve(std::vector<T> &v, size_t capacity) {
+	v.reserve(capacity);
+}
+
+template<typename T>
+void EmplaceAt(Vector<T> &v, size_t index, T &&value) {
+	v.Emplace(v.begin() + index, std::move(value));
+}
+template<typename T>
+void EmplaceAt(std::vector<T> &v, size_t index, T &&value) {
+	v.emplace(v.begin() + index, std::move(value));
+}
+
+template<typename T>
+void EraseAt(Vector<T> &v, size_t index) {
+	v.Erase(v.begin() + index);
+}
+template<typename T>
+void EraseAt(std::vector<T> &v, size_t index) {
+	v.erase(v.begin() + index);
+}
+
+template<typename T>
+size_t Size(const Vector<T> &v) {
+	return v.Size();
+}
+template<typename T>
+size_t Size(const std::vector<T> &v) {
+	return v.size();
+}
+
+template<typename Container>
+using ValueOf = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+
+template<typename Container>
+Container MakeFilled(size_t n) {
+	using T = ValueOf<Container>;
+	Container v;
+	Reserve(v, n);
+	for (size_t i = 0; i < n; ++i) {
+		EmplaceBack(v, MakeValue<T>(i));
+	}
+	return v;
+}
+
+template<typename Container>
+void BM_PushBack(benchmark::State &state) {
+	using T = ValueOf<Container>;
+	const size_t n = state.range(0);
+	const T value = MakeValue<T>(0);
+	for (auto _ : state) {
+		Container v;
+		for (size_t i = 0; i < n; ++i) {
+			PushBack(v, value);
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Container>
+void BM_EmplaceBack(benchmark::State &state) {
+	using T = ValueOf<Container>;
+	const size_t n = state.range(0);
+	for (auto _ : state) {
+		Container v;
+		for (size_t i = 0; i < n; ++i) {
+			EmplaceBack(v, MakeValue<T>(i));
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Стоимость одной реаллокации заполненного вектора
+template<typename Container>
+void BM_Reserve(benchmark::State &state) {
+	const size_t n = state.range(0);
+	for (auto _ : state) {
+		state.PauseTiming();
+		Container v = MakeFilled<Container>(n);
+		state.ResumeTiming();
+		Reserve(v, n * 2);
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Container>
+void BM_EmplaceFront(benchmark::State &state) {
+	using T = ValueOf<Container>;
+	const size_t n = state.range(0);
+	for (auto _ : state) {
+		Container v;
+		for (size_t i = 0; i < n; ++i) {
+			EmplaceAt(v, 0, MakeValue<T>(i));
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Container>
+void BM_EmplaceMiddle(benchmark::State &state) {
+	using T = ValueOf<Container>;
+	const size_t n = state.range(0);
+	for (auto _ : state) {
+		Container v;
+		for (size_t i = 0; i < n; ++i) {
+			EmplaceAt(v, Size(v) / 2, MakeValue<T>(i));
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Container>
+void BM_EraseFront(benchmark::State &state) {
+	const size_t n = state.range(0);
+	for (auto _ : state) {
+		state.PauseTiming();
+		Container v = MakeFilled<Container>(n);
+		state.ResumeTiming();
+		while (Size(v) != 0) {
+			EraseAt(v, 0);
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Копирующее присваивание в вектор достаточной ёмкости переиспользует его память
+template<typename Container>
+void BM_CopyAssignReuse(benchmark::State &state) {
+	const size_t n = state.range(0);
+	const Container source = MakeFilled<Container>(n);
+	Container target = MakeFilled<Container>(n);
+	for (auto _ : state) {
+		target = source;
+		benchmark::DoNotOptimize(target);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Container>
+void BM_Move(benchmark::State &state) {
+	const size_t n = state.range(0);
+	Container a = MakeFilled<Container>(n);
+	for (auto _ : state) {
+		Container b(std::move(a));
+		a = std::move(b);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+// Векторное ядро Sum против последовательного сложения
+template<bool UseKernels>
+void BM_SumFloat(benchmark::State &state) {
+	const size_t n = state.range(0);
+	Vector<float> v(n);
+	Fill(v, 1.5f);
+	for (auto _ : state) {
+		float sum = UseKernels ? Sum(v) : vector_simd::SumScalar(v.Data(), v.Size());
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<bool UseKernels>
+void BM_FindInt(benchmark::State &state) {
+	const size_t n = state.range(0);
+	Vector<int32_t> v(n);
+	for (auto _ : state) {
+		size_t index = UseKernels ? Find(v, int32_t(1)) : vector_simd::FindScalar(v.Data(), v.Size(), int32_t(1));
+		benchmark::DoNotOptimize(index);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+bool FindKey(const FlatSet<int> &set, int key) {
+	return set.Contains(key);
+}
+bool FindKey(const std::set<int> &set, int key) {
+	return set.count(key) != 0;
+}
+
+// Подсчёт флагов: по байту на флаг против BitVector
+template<bool Packed>
+void BM_CountFlags(benchmark::State &state) {
+	const size_t n = state.range(0);
+	Vector<uint8_t> bytes(n);
+	BitVector<> bits(n);
+	for (size_t i = 0; i < n; i += 3) {
+		bytes[i] = 1;
+		bits.Set(i);
+	}
+	for (auto _ : state) {
+		size_t count = Packed ? bits.Count() : Count(bytes, uint8_t(1));
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Поиск ключей в FlatSet против узлового std::set
+template<typename Set>
+void BM_Lookup(benchmark::State &state) {
+	const size_t n = state.range(0);
+	Vector<int> keys;
+	for (size_t i = 0; i < n; ++i) {
+		keys.PushBack(static_cast<int>(i * 2654435761u % (n * 4)));
+	}
+	const Set set(keys.begin(), keys.end());
+	size_t probe = 0;
+	for (auto _ : state) {
+		probe = (probe + 7919) % (n * 4);
+		bool found = FindKey(set, static_cast<int>(probe));
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+constexpr int64_t kMinSize = 8;
+constexpr int64_t kMaxSize = 1 << 16;
+constexpr int64_t kMaxInsertSize = 1 << 12;
+
+}  // namespace
+
+#define VECTOR_BENCHMARK(Name, T, MaxSize) \
+	BENCHMARK_TEMPLATE(Name, Vector<T>)->RangeMultiplier(8)->Range(kMinSize, MaxSize); \
+	BENCHMARK_TEMPLATE(Name, std::vector<T>)->RangeMultiplier(8)->Range(kMinSize, MaxSize)
+
+#define VECTOR_BENCHMARKS_FOR(T) \
+	VECTOR_BENCHMARK(BM_PushBack, T, kMaxSize); \
+	VECTOR_BENCHMARK(BM_EmplaceBack, T, kMaxSize); \
+	VECTOR_BENCHMARK(BM_Reserve, T, kMaxSize); \
+	VECTOR_BENCHMARK(BM_EmplaceFront, T, kMaxInsertSize); \
+	VECTOR_BENCHMARK(BM_EmplaceMiddle, T, kMaxInsertSize); \
+	VECTOR_BENCHMARK(BM_EraseFront, T, kMaxInsertSize); \
+	VECTOR_BENCHMARK(BM_CopyAssignReuse, T, kMaxSize); \
+	VECTOR_BENCHMARK(BM_Move, T, kMaxSize)
+
+VECTOR_BENCHMARKS_FOR(int);
+VECTOR_BENCHMARKS_FOR(std::string);
+VECTOR_BENCHMARKS_FOR(ThrowingMove);
+
+BENCHMARK_TEMPLATE(BM_SumFloat, true)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_SumFloat, false)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_FindInt, true)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_FindInt, false)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_CountFlags, true)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_CountFlags, false)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_Lookup, FlatSet<int>)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_Lookup, std::set<int>)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);
@@ -0,0 +1,462 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "vector.h"
+#include "vector_algorithms.h"
+
+// Ядра для массивов 64-битных слов. На x86-64 с AVX2 слова обрабатываются по четыре за инструкцию,
+// а подсчёт единиц идёт инструкцией popcnt; на AArch64 используется NEON
+namespace bit_simd {
+
+inline size_t PopcountScalar(const uint64_t *words, size_t n) noexcept {
+	size_t count = 0;
+	for (size_t i = 0; i < n; ++i) {
+		count += std::popcount(words[i]);
+	}
+	return count;
+}
+
+// Индекс первого ненулевого слова в [from, n) или n
+inline size_t FindNonZeroScalar(const uint64_t *words, size_t from, size_t n) noexcept {
+	while (from < n && words[from] == 0) {
+		++from;
+	}
+	return from;
+}
+
+template<typename Op>
+void ApplyScalar(uint64_t *dest, const uint64_t *src, size_t n, Op op) noexcept {
+	for (size_t i = 0; i < n; ++i) {
+		dest[i] = op(dest[i], src[i]);
+	}
+}
+
+enum class BitOp {
+	kAnd,
+	kOr,
+	kXor,
+	kAndNot
+};
+
+template<BitOp kOp>
+constexpr uint64_t Combine(uint64_t a, uint64_t b) noexcept {
+	if constexpr (kOp == BitOp::kAnd) {
+		return a & b;
+	} else if constexpr (kOp == BitOp::kOr) {
+		return a | b;
+	} else if constexpr (kOp == BitOp::kXor) {
+		return a ^ b;
+	} else {
+		return a & ~b;
+	}
+}
+
+#if defined(VECTOR_SIMD_X86)
+
+#define BIT_SIMD_AVX2 __attribute__((target("avx2,popcnt")))
+
+// Четыре независимых счётчика не упираются в задержку сложения
+BIT_SIMD_AVX2 inline size_t PopcountAvx2(const uint64_t *words, size_t n) noexcept {
+	uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		c0 += _mm_popcnt_u64(words[i]);
+		c1 += _mm_popcnt_u64(words[i + 1]);
+		c2 += _mm_popcnt_u64(words[i + 2]);
+		c3 += _mm_popcnt_u64(words[i + 3]);
+	}
+	for (; i < n; ++i) {
+		c0 += _mm_popcnt_u64(words[i]);
+	}
+	return c0 + c1 + c2 + c3;
+}
+
+BIT_SIMD_AVX2 inline size_t FindNonZeroAvx2(const uint64_t *words, size_t from, size_t n) noexcept {
+	for (; from + 4 <= n; from += 4) {
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + from));
+		if (!_mm256_testz_si256(v, v)) {
+			break;
+		}
+	}
+	return FindNonZeroScalar(words, from, n);
+}
+
+template<BitOp kOp>
+BIT_SIMD_AVX2 inline __m256i CombineAvx2(__m256i a, __m256i b) noexcept {
+	if constexpr (kOp == BitOp::kAnd) {
+		return _mm256_and_si256(a, b);
+	} else if constexpr (kOp == BitOp::kOr) {
+		return _mm256_or_si256(a, b);
+	} else if constexpr (kOp == BitOp::kXor) {
+		return _mm256_xor_si256(a, b);
+	} else {
+		return _mm256_andnot_si256(b, a);
+	}
+}
+
+template<BitOp kOp>
+BIT_SIMD_AVX2 inline void ApplyAvx2(uint64_t *dest, const uint64_t *src, size_t n) noexcept {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i *d = reinterpret_cast<__m256i*>(dest + i);
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		_mm256_storeu_si256(d, CombineAvx2<kOp>(_mm256_loadu_si256(d), s));
+	}
+	ApplyScalar(dest + i, src + i, n - i, Combine<kOp>);
+}
+
+#elif defined(VECTOR_SIMD_NEON)
+
+inline size_t PopcountNeon(const uint64_t *words, size_t n) noexcept {
+	size_t count = 0;
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		count += vaddlvq_u8(vcntq_u8(vreinterpretq_u8_u64(vld1q_u64(words + i))));
+	}
+	return count + PopcountScalar(words + i, n - i);
+}
+
+template<BitOp kOp>
+inline void ApplyNeon(uint64_t *dest, const uint64_t *src, size_t n) noexcept {
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		const uint64x2_t a = vld1q_u64(dest + i);
+		const uint64x2_t b = vld1q_u64(src + i);
+		uint64x2_t r;
+		if constexpr (kOp == BitOp::kAnd) {
+			r = vandq_u64(a, b);
+		} else if constexpr (kOp == BitOp::kOr) {
+			r = vorrq_u64(a, b);
+		} else if constexpr (kOp == BitOp::kXor) {
+			r = veorq_u64(a, b);
+		} else {
+			r = vbicq_u64(a, b);
+		}
+		vst1q_u64(dest + i, r);
+	}
+	ApplyScalar(dest + i, src + i, n - i, Combine<kOp>);
+}
+
+#endif
+
+inline size_t Popcount(const uint64_t *words, size_t n) noexcept {
+#if defined(VECTOR_SIMD_X86)
+	if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+		return PopcountAvx2(words, n);
+	}
+#elif defined(VECTOR_SIMD_NEON)
+	return PopcountNeon(words, n);
+#endif
+	return PopcountScalar(words, n);
+}
+
+inline size_t FindNonZero(const uint64_t *words, size_t from, size_t n) noexcept {
+#if defined(VECTOR_SIMD_X86)
+	if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+		return FindNonZeroAvx2(words, from, n);
+	}
+#endif
+	return FindNonZeroScalar(words, from, n);
+}
+
+template<BitOp kOp>
+void Apply(uint64_t *dest, const uint64_t *src, size_t n) noexcept {
+#if defined(VECTOR_SIMD_X86)
+	if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+		ApplyAvx2<kOp>(dest, src, n);
+		return;
+	}
+#elif defined(VECTOR_SIMD_NEON)
+	ApplyNeon<kOp>(dest, src, n);
+	return;
+#endif
+	ApplyScalar(dest, src, n, Combine<kOp>);
+}
+
+}  // namespace bit_simd
+
+// Вектор флагов, упакованных по 64 в слово RawMemory<uint64_t>: в 8 раз компактнее Vector<bool>
+// или Vector<uint8_t>, а подсчёт, поиск и поразрядные операции идут словами, а не битами.
+// Биты последнего слова за пределами Size() всегда нулевые
+template<typename Allocator = std::allocator<uint64_t>, typename GrowthPolicy = DoublingGrowth>
+class BitVector {
+	static constexpr size_t kWordBits = 64;
+	using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+	using allocator_type = Allocator;
+
+	// Ссылка на бит, которую возвращает неконстантный operator[]
+	class Reference {
+	public:
+		Reference& operator=(bool value) noexcept {
+			*word_ = value ? *word_ | mask_ : *word_ & ~mask_;
+			return *this;
+		}
+		Reference& operator=(const Reference &other) noexcept {
+			return *this = static_cast<bool>(other);
+		}
+
+		operator bool() const noexcept {
+			return (*word_ & mask_) != 0;
+		}
+
+		void Flip() noexcept {
+			*word_ ^= mask_;
+		}
+
+	private:
+		friend class BitVector;
+
+		Reference(uint64_t *word, uint64_t mask) noexcept :
+				word_(word), mask_(mask) {
+		}
+
+		uint64_t *word_;
+		uint64_t mask_;
+	};
+
+	BitVector() = default;
+
+	explicit BitVector(const Allocator &alloc) noexcept :
+			data_(alloc) {
+	}
+
+	explicit BitVector(size_t size, bool value = false, const Allocator &alloc = Allocator()) :
+			data_(WordCount(size), alloc), size_(size) {
+		std::fill_n(data_.GetAddress(), WordCount(size), value ? ~uint64_t(0) : 0);
+		ClearTail();
+	}
+
+	BitVector(const BitVector &other) :
+			data_(WordCount(other.size_), std::allocator_traits<Allocator>::select_on_container_copy_construction(
+					other.GetAllocator())), size_(other.size_) {
+		CopyWords(other.data_.GetAddress(), WordCount(size_), data_.GetAddress());
+	}
+
+	BitVector& operator=(const BitVector &other) {
+		if (this != &other) {
+			if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+				if (GetAllocator() != other.GetAllocator()) {
+					// Память, выделенную старым аллокатором, нужно вернуть ему же
+					data_ = RawMemory<uint64_t, Allocator>(other.GetAllocator());
+				} else {
+					data_.GetAllocator() = other.GetAllocator();
+				}
+			}
+			AssignFrom(other);
+		}
+		return *this;
+	}
+
+	BitVector(BitVector &&other) noexcept :
+			data_(std::move(other.data_)), size_(std::exchange(other.size_, 0)) {
+	}
+
+	BitVector& operator=(BitVector &&other) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+			|| AllocTraits::is_always_equal::value) {
+		if (this != &other) {
+			if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+				data_ = std::move(other.data_);
+				size_ = std::exchange(other.size_, 0);
+			} else if (GetAllocator() == other.GetAllocator()) {
+				data_.SwapBuffers(other.data_);
+				size_ = std::exchange(other.size_, 0);
+			} else {
+				// Аллокаторы не равны и не распространяются: буфер other забрать нельзя
+				AssignFrom(other);
+			}
+		}
+		return *this;
+	}
+
+	void Swap(BitVector &other) noexcept {
+		if constexpr (AllocTraits::propagate_on_container_swap::value) {
+			data_.Swap(other.data_);
+		} else {
+			assert(GetAllocator() == other.GetAllocator());
+			data_.SwapBuffers(other.data_);
+		}
+		std::swap(size_, other.size_);
+	}
+
+	// Резервирует место под bits флагов
+	void Reserve(size_t bits) {
+		const size_t words = WordCount(bits);
+		if (words > data_.Capacity()) {
+			RawMemory<uint64_t, Allocator> new_data(words, data_.GetAllocator());
+			CopyWords(data_.GetAddress(), WordCount(size_), new_data.GetAddress());
+			data_.Swap(new_data);
+		}
+	}
+
+	void Resize(size_t new_size, bool value = false) {
+		if (new_size > size_) {
+			Reserve(new_size);
+			const size_t old_words = WordCount(size_);
+			std::fill(data_.GetAddress() + old_words, data_.GetAddress() + WordCount(new_size), value ? ~uint64_t(0) : 0);
+			if (value && size_ % kWordBits != 0) {
+				data_[size_ / kWordBits] |= ~uint64_t(0) << size_ % kWordBits;
+			}
+		}
+		size_ = new_size;
+		ClearTail();
+	}
+
+	void PushBack(bool value) {
+		if (size_ % kWordBits == 0) {
+			if (WordCount(size_ + 1) > data_.Capacity()) {
+				Reserve(GrowthPolicy::NextCapacity(data_.Capacity(), WordCount(size_ + 1), sizeof(uint64_t)) * kWordBits);
+			}
+			data_[size_ / kWordBits] = 0;
+		}
+		data_[size_ / kWordBits] |= uint64_t(value) << size_ % kWordBits;
+		++size_;
+	}
+
+	void PopBack() noexcept {
+		assert(size_ != 0);
+		--size_;
+		ClearTail();
+	}
+
+	void Clear() noexcept {
+		size_ = 0;
+	}
+
+	bool operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return (data_[index / kWordBits] >> index % kWordBits) & 1;
+	}
+
+	Reference operator[](size_t index) noexcept {
+		assert(index < size_);
+		return Reference(&data_[index / kWordBits], uint64_t(1) << index % kWordBits);
+	}
+
+	void Set(size_t index, bool value = true) noexcept {
+		(*this)[index] = value;
+	}
+
+	void Flip(size_t index) noexcept {
+		(*this)[index].Flip();
+	}
+
+	// Присваивает всем флагам значение value
+	void Fill(bool value) noexcept {
+		std::fill_n(data_.GetAddress(), WordCount(size_), value ? ~uint64_t(0) : 0);
+		ClearTail();
+	}
+
+	// Число установленных флагов
+	size_t Count() const noexcept {
+		return bit_simd::Popcount(data_.GetAddress(), WordCount(size_));
+	}
+
+	// Индекс первого установленного флага или Size(), если таких нет
+	size_t FindFirst() const noexcept {
+		return FindFromWord(0);
+	}
+
+	// Индекс первого установленного флага после pos или Size()
+	size_t FindNext(size_t pos) const noexcept {
+		const size_t next = pos + 1;
+		if (next >= size_) {
+			return size_;
+		}
+		const uint64_t rest = data_[next / kWordBits] & (~uint64_t(0) << next % kWordBits);
+		if (rest != 0) {
+			return next / kWordBits * kWordBits + std::countr_zero(rest);
+		}
+		return FindFromWord(next / kWordBits + 1);
+	}
+
+	// Поразрядные операции с вектором того же размера
+	BitVector& operator&=(const BitVector &other) noexcept {
+		return Apply<bit_simd::BitOp::kAnd>(other);
+	}
+	BitVector& operator|=(const BitVector &other) noexcept {
+		return Apply<bit_simd::BitOp::kOr>(other);
+	}
+	BitVector& operator^=(const BitVector &other) noexcept {
+		return Apply<bit_simd::BitOp::kXor>(other);
+	}
+	// Сбрасывает флаги, установленные в other
+	BitVector& AndNot(const BitVector &other) noexcept {
+		return Apply<bit_simd::BitOp::kAndNot>(other);
+	}
+
+	bool operator==(const BitVector &other) const noexcept {
+		return size_ == other.size_ && std::equal(Words().begin(), Words().end(), other.Words().begin());
+	}
+
+	size_t Size() const noexcept {
+		return size_;
+	}
+
+	// Ёмкость в флагах
+	size_t Capacity() const noexcept {
+		return data_.Capacity() * kWordBits;
+	}
+
+	// Слова, хранящие флаги: флаг i — бит i % 64 слова i / 64
+	std::span<const uint64_t> Words() const noexcept {
+		return {data_.GetAddress(), WordCount(size_)};
+	}
+
+	const Allocator& GetAllocator() const noexcept {
+		return data_.GetAllocator();
+	}
+
+private:
+	static size_t WordCount(size_t bits) noexcept {
+		return (bits + kWordBits - 1) / kWordBits;
+	}
+
+	static void CopyWords(const uint64_t *from, size_t count, uint64_t *to) noexcept {
+		if (count != 0) {
+			std::memcpy(to, from, count * sizeof(uint64_t));
+		}
+	}
+
+	// Копирует биты other в буфер текущего аллокатора, выделяя новый, только если старого не хватает
+	void AssignFrom(const BitVector &other) {
+		if (WordCount(other.size_) > data_.Capacity()) {
+			RawMemory<uint64_t, Allocator> new_data(WordCount(other.size_), data_.GetAllocator());
+			data_.SwapBuffers(new_data);
+		}
+		CopyWords(other.data_.GetAddress(), WordCount(other.size_), data_.GetAddress());
+		size_ = other.size_;
+	}
+
+	// Обнуляет биты последнего слова за пределами size_
+	void ClearTail() noexcept {
+		if (size_ % kWordBits != 0) {
+			data_[size_ / kWordBits] &= ~(~uint64_t(0) << size_ % kWordBits);
+		}
+	}
+
+	size_t FindFromWord(size_t word) const noexcept {
+		const size_t words = WordCount(size_);
+		const size_t found = bit_simd::FindNonZero(data_.GetAddress(), word, words);
+		return found == words ? size_ : found * kWordBits + std::countr_zero(data_[found]);
+	}
+
+	template<bit_simd::BitOp kOp>
+	BitVector& Apply(const BitVector &other) noexcept {
+		assert(size_ == other.size_);
+		bit_simd::Apply<kOp>(data_.GetAddress(), other.data_.GetAddress(), WordCount(size_));
+		return *this;
+	}
+
+	RawMemory<uint64_t, Allocator> data_;
+	size_t size_ = 0;
+};
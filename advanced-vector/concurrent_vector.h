@@ -0,0 +1,312 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор, в конец которого могут одновременно добавлять элементы несколько потоков без блокировок.
+// Память состоит из сегментов, каждый следующий вдвое больше предыдущего, поэтому элементы никогда
+// не перемещаются и ссылки на них остаются действительными до разрушения вектора.
+// EmplaceBack занимает слот атомарным compare-exchange, создаёт в нём элемент и отмечает слот готовым.
+// Size() — длина непрерывного префикса готовых слотов: его продвигает тот поток, который заполнил
+// последнюю недостающую ячейку, поэтому ни один поток не ждёт другие. Читатели без блокировок видят
+// элементы [0, Size()) целиком созданными; элемент, добавленный после ещё не готового слота, становится
+// виден вместе с ним
+template<typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVector {
+	static constexpr size_t kFirstSegmentBits = 4;
+	static constexpr size_t kSegmentCount = sizeof(size_t) * 8 - kFirstSegmentBits;
+	static constexpr size_t kWordBits = 64;
+
+	// Сегмент — один блок: слова флагов готовности слотов, за ними элементы. Блок выделяется
+	// единицами Unit, выровненными и под флаги, и под элементы
+	static constexpr size_t kAlign = std::max(alignof(T), alignof(std::atomic<uint64_t>));
+
+	struct alignas(kAlign) Unit {
+		unsigned char bytes[kAlign];
+	};
+
+	using UnitAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Unit>;
+	using UnitTraits = std::allocator_traits<UnitAllocator>;
+
+	// Слот уже занят, когда элемент начинает создаваться, поэтому создание в слоте не должно бросать
+	template<typename ... Args>
+	static constexpr bool kConstructInPlace = std::is_nothrow_constructible_v<T, Args...>;
+
+	static_assert(std::is_nothrow_move_constructible_v<T>, "ConcurrentVector requires a nothrow move constructor");
+
+public:
+	class ConstIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		ConstIterator() = default;
+
+		const T& operator*() const noexcept {
+			return *item_;
+		}
+		const T* operator->() const noexcept {
+			return item_;
+		}
+
+		ConstIterator& operator++() noexcept {
+			++index_;
+			if (++item_ == segment_end_) {
+				Locate();
+			}
+			return *this;
+		}
+		ConstIterator operator++(int) noexcept {
+			ConstIterator old = *this;
+			++*this;
+			return old;
+		}
+
+		bool operator==(const ConstIterator &other) const noexcept {
+			return index_ == other.index_;
+		}
+		bool operator!=(const ConstIterator &other) const noexcept {
+			return index_ != other.index_;
+		}
+
+	private:
+		friend class ConcurrentVector;
+
+		ConstIterator(const ConcurrentVector *owner, size_t index) noexcept :
+				owner_(owner), index_(index) {
+			Locate();
+		}
+
+		// Сегмент ещё не опубликованного элемента может быть не выделен; такой итератор
+		// не разыменовывается, так как стоит не раньше end()
+		void Locate() noexcept {
+			const size_t segment = SegmentOf(index_);
+			if (Unit *base = owner_->segments_[segment].load(std::memory_order_acquire)) {
+				item_ = ItemsOf(base, segment) + OffsetIn(segment, index_);
+				segment_end_ = ItemsOf(base, segment) + SegmentSize(segment);
+			}
+		}
+
+		const ConcurrentVector *owner_ = nullptr;
+		size_t index_ = 0;
+		const T *item_ = nullptr;
+		const T *segment_end_ = nullptr;
+	};
+
+	using const_iterator = ConstIterator;
+
+	ConcurrentVector() = default;
+
+	explicit ConcurrentVector(const Allocator &alloc) noexcept :
+			alloc_(alloc) {
+	}
+
+	ConcurrentVector(const ConcurrentVector&) = delete;
+	ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+	// Разрушение не должно пересекаться с добавлением элементов
+	~ConcurrentVector() {
+		const size_t size = size_.load(std::memory_order_acquire);
+		for (size_t segment = 0; segment < kSegmentCount; ++segment) {
+			Unit *base = segments_[segment].load(std::memory_order_acquire);
+			if (base == nullptr) {
+				continue;
+			}
+			if (SegmentStart(segment) < size) {
+				std::destroy_n(ItemsOf(base, segment), std::min(SegmentSize(segment), size - SegmentStart(segment)));
+			}
+			UnitTraits::deallocate(alloc_, base, SegmentUnits(segment));
+		}
+	}
+
+	// Заранее выделяет сегменты под capacity элементов
+	void Reserve(size_t capacity) {
+		for (size_t segment = 0; segment < kSegmentCount && SegmentStart(segment) < capacity; ++segment) {
+			EnsureSegment(segment);
+		}
+	}
+
+	template<typename M>
+	void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
+	}
+
+	// Добавляет элемент; безопасен при одновременном вызове из нескольких потоков
+	template<typename ... Args>
+	T& EmplaceBack(Args &&... args) {
+		if constexpr (kConstructInPlace<Args...>) {
+			const size_t index = ClaimSlot();
+			T *item = new (Slot(index)) T(std::forward<Args>(args)...);
+			Publish(index);
+			return *item;
+		} else {
+			// Исключение при создании не должно оставить занятый слот пустым
+			T value(std::forward<Args>(args)...);
+			const size_t index = ClaimSlot();
+			T *item = new (Slot(index)) T(std::move(value));
+			Publish(index);
+			return *item;
+		}
+	}
+
+	// Число опубликованных элементов
+	size_t Size() const noexcept {
+		return size_.load(std::memory_order_acquire);
+	}
+
+	// Ёмкость уже выделенных сегментов, начиная с первого
+	size_t Capacity() const noexcept {
+		size_t segment = 0;
+		while (segment < kSegmentCount && segments_[segment].load(std::memory_order_acquire) != nullptr) {
+			++segment;
+		}
+		return SegmentStart(segment);
+	}
+
+	// Элемент index < Size()
+	T& operator[](size_t index) noexcept {
+		return *Locate(index);
+	}
+
+	const T& operator[](size_t index) const noexcept {
+		return *Locate(index);
+	}
+
+	// Обход элементов, опубликованных к моменту вызова end()
+	ConstIterator begin() const noexcept {
+		return ConstIterator(this, 0);
+	}
+	ConstIterator end() const noexcept {
+		return ConstIterator(this, Size());
+	}
+
+private:
+	static constexpr size_t kFirstSegmentSize = size_t(1) << kFirstSegmentBits;
+
+	// Сегмент segment начинается с элемента kFirstSegmentSize * (2^segment - 1) и вмещает
+	// kFirstSegmentSize * 2^segment элементов
+	static constexpr size_t SegmentStart(size_t segment) noexcept {
+		return segment < kSegmentCount ? ((size_t(1) << segment) - 1) << kFirstSegmentBits : static_cast<size_t>(-1);
+	}
+
+	static constexpr size_t SegmentSize(size_t segment) noexcept {
+		return kFirstSegmentSize << segment;
+	}
+
+	static size_t SegmentOf(size_t index) noexcept {
+		return std::bit_width((index >> kFirstSegmentBits) + 1) - 1;
+	}
+
+	static size_t OffsetIn(size_t segment, size_t index) noexcept {
+		return index - SegmentStart(segment);
+	}
+
+	static constexpr size_t FlagWords(size_t segment) noexcept {
+		return (SegmentSize(segment) + kWordBits - 1) / kWordBits;
+	}
+
+	static constexpr size_t FlagUnits(size_t segment) noexcept {
+		return (FlagWords(segment) * sizeof(std::atomic<uint64_t>) + kAlign - 1) / kAlign;
+	}
+
+	static constexpr size_t SegmentUnits(size_t segment) noexcept {
+		return FlagUnits(segment) + (SegmentSize(segment) * sizeof(T) + kAlign - 1) / kAlign;
+	}
+
+	static std::atomic<uint64_t>* FlagsOf(Unit *base) noexcept {
+		return std::launder(reinterpret_cast<std::atomic<uint64_t>*>(base));
+	}
+
+	static T* ItemsOf(Unit *base, size_t segment) noexcept {
+		return reinterpret_cast<T*>(base + FlagUnits(segment));
+	}
+
+	T* Locate(size_t index) const noexcept {
+		assert(index < Size());
+		return Slot(index);
+	}
+
+	// Возвращает сегмент, при необходимости выделяя его. Если сегмент одновременно выделили несколько
+	// потоков, остаётся блок первого, остальные освобождаются
+	Unit* EnsureSegment(size_t segment) {
+		Unit *base = segments_[segment].load(std::memory_order_acquire);
+		if (base != nullptr) {
+			return base;
+		}
+		Unit *candidate = UnitTraits::allocate(alloc_, SegmentUnits(segment));
+		std::atomic<uint64_t> *flags = reinterpret_cast<std::atomic<uint64_t>*>(candidate);
+		for (size_t i = 0; i < FlagWords(segment); ++i) {
+			std::construct_at(flags + i, 0);
+		}
+		if (segments_[segment].compare_exchange_strong(base, candidate, std::memory_order_acq_rel)) {
+			return candidate;
+		}
+		UnitTraits::deallocate(alloc_, candidate, SegmentUnits(segment));
+		return base;
+	}
+
+	// Занимает следующий слот и возвращает его индекс. Занятый слот нельзя вернуть, поэтому сегмент
+	// выделяется до того, как слот занят: при нехватке памяти исключение уходит вызывающему, а вектор
+	// не меняется. Неудача compare-exchange означает, что слот занял другой поток
+	size_t ClaimSlot() {
+		size_t index = claimed_.load(std::memory_order_relaxed);
+		do {
+			EnsureSegment(SegmentOf(index));
+		} while (!claimed_.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+		return index;
+	}
+
+	T* Slot(size_t index) const noexcept {
+		const size_t segment = SegmentOf(index);
+		return ItemsOf(segments_[segment].load(std::memory_order_acquire), segment) + OffsetIn(segment, index);
+	}
+
+	bool IsReady(size_t index) const noexcept {
+		const size_t segment = SegmentOf(index);
+		Unit *base = segments_[segment].load(std::memory_order_acquire);
+		if (base == nullptr) {
+			return false;
+		}
+		const size_t offset = OffsetIn(segment, index);
+		return (FlagsOf(base)[offset / kWordBits].load() >> offset % kWordBits & 1) != 0;
+	}
+
+	// Отмечает слот index готовым и продвигает Size() до первого неготового слота. Если предыдущий слот
+	// ещё не готов, префикс продвинет поток, который его заполнит: установка флага и чтение Size()
+	// последовательно согласованы, поэтому хотя бы один из двух потоков увидит оба флага
+	void Publish(size_t index) noexcept {
+		const size_t segment = SegmentOf(index);
+		const size_t offset = OffsetIn(segment, index);
+		FlagsOf(segments_[segment].load(std::memory_order_acquire))[offset / kWordBits].fetch_or(
+				uint64_t(1) << offset % kWordBits);
+		size_t size = size_.load();
+		while (true) {
+			size_t end = size;
+			while (IsReady(end)) {
+				++end;
+			}
+			if (end == size || size_.compare_exchange_weak(size, end)) {
+				return;
+			}
+		}
+	}
+
+	[[no_unique_address]] UnitAllocator alloc_;
+	// Единственные владельцы блоков сегментов
+	std::atomic<Unit*> segments_[kSegmentCount] = {};
+	alignas(64) std::atomic<size_t> claimed_ = 0;
+	alignas(64) std::atomic<size_t> size_ = 0;
+};
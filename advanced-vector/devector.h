@@ -0,0 +1,371 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Непрерывный массив с запасом ёмкости с обеих сторон одного буфера RawMemory. Добавление в начало
+// и в конец выполняется за амортизированное O(1), вставка и удаление в середине сдвигают меньшую
+// из двух частей массива. Итерация по-прежнему идёт по непрерывному диапазону указателей
+template<typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class Devector {
+	using AllocTraits = std::allocator_traits<Allocator>;
+public:
+	using iterator = T*;
+	using const_iterator = const T*;
+	using allocator_type = Allocator;
+
+	Devector() = default;
+
+	explicit Devector(const Allocator &alloc) noexcept :
+			data_(alloc) {
+	}
+
+	Devector(std::initializer_list<T> items, const Allocator &alloc = Allocator()) :
+			data_(items.size(), alloc) {
+		std::uninitialized_copy_n(items.begin(), items.size(), data_.GetAddress());
+		size_ = items.size();
+	}
+
+	Devector(const Devector &other) :
+			data_(other.size_, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator())) {
+		std::uninitialized_copy_n(other.begin(), other.size_, data_.GetAddress());
+		size_ = other.size_;
+	}
+
+	Devector& operator=(const Devector &other) {
+		if (this != &other) {
+			if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+				if (GetAllocator() != other.GetAllocator()) {
+					// Память, выделенную старым аллокатором, нужно вернуть ему же
+					Clear();
+					data_ = RawMemory<T, Allocator>(other.GetAllocator());
+					front_ = 0;
+				} else {
+					data_.GetAllocator() = other.GetAllocator();
+				}
+			}
+			AssignFrom(other.begin(), other.size_);
+		}
+		return *this;
+	}
+
+	Devector(Devector &&other) noexcept :
+			data_(std::move(other.data_)), front_(std::exchange(other.front_, 0)), size_(std::exchange(other.size_, 0)) {
+	}
+
+	Devector& operator=(Devector &&other) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+			|| AllocTraits::is_always_equal::value) {
+		if (this != &other) {
+			if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+				Clear();
+				data_ = std::move(other.data_);
+				front_ = std::exchange(other.front_, 0);
+				size_ = std::exchange(other.size_, 0);
+			} else if (GetAllocator() == other.GetAllocator()) {
+				Clear();
+				data_.SwapBuffers(other.data_);
+				std::swap(front_, other.front_);
+				size_ = std::exchange(other.size_, 0);
+			} else {
+				// Аллокаторы не равны и не распространяются: буфер other забрать нельзя
+				AssignFrom(std::make_move_iterator(other.begin()), other.size_);
+			}
+		}
+		return *this;
+	}
+
+	~Devector() {
+		std::destroy_n(begin(), size_);
+	}
+
+	void Swap(Devector &other) noexcept {
+		if constexpr (AllocTraits::propagate_on_container_swap::value) {
+			data_.Swap(other.data_);
+		} else {
+			assert(GetAllocator() == other.GetAllocator());
+			data_.SwapBuffers(other.data_);
+		}
+		std::swap(front_, other.front_);
+		std::swap(size_, other.size_);
+	}
+
+	// Гарантирует запас не меньше count элементов перед первым элементом
+	void ReserveFront(size_t count) {
+		if (count > FrontSpare()) {
+			Reallocate(size_ + count + BackSpare(), count);
+		}
+	}
+
+	// Гарантирует запас не меньше count элементов после последнего элемента
+	void ReserveBack(size_t count) {
+		if (count > BackSpare()) {
+			Reallocate(front_ + size_ + count, front_);
+		}
+	}
+
+	template<typename M>
+	void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
+	}
+
+	template<typename ... Args>
+	T& EmplaceBack(Args &&... args) {
+		return *Emplace(end(), std::forward<Args>(args)...);
+	}
+
+	template<typename M>
+	void PushFront(M &&value) {
+		EmplaceFront(std::forward<M>(value));
+	}
+
+	template<typename ... Args>
+	T& EmplaceFront(Args &&... args) {
+		return *Emplace(begin(), std::forward<Args>(args)...);
+	}
+
+	template<typename ... Args>
+	iterator Emplace(const_iterator pos, Args &&... args) {
+		const size_t pos_index = pos - begin();
+		// Сдвигается меньшая часть массива; если с её стороны запас исчерпан, буфер перераспределяется
+		const bool to_front = pos_index * 2 < size_;
+		if (to_front ? FrontSpare() == 0 : BackSpare() == 0) {
+			return GrowAndEmplace(pos_index, to_front, std::forward<Args>(args)...);
+		}
+		T *first = begin();
+		if (to_front ? pos_index == 0 : pos_index == size_) {
+			new (to_front ? first - 1 : first + size_) T(std::forward<Args>(args)...);
+		} else if (to_front) {
+			vector_detail::EmplaceInFrontGap(first, size_, pos_index, std::forward<Args>(args)...);
+		} else {
+			vector_detail::EmplaceInGap(first, size_, pos_index, std::forward<Args>(args)...);
+		}
+		if (to_front) {
+			--front_;
+		}
+		++size_;
+		return begin() + pos_index;
+	}
+
+	iterator Insert(const_iterator pos, const T &item) {
+		return Emplace(pos, item);
+	}
+	iterator Insert(const_iterator pos, T &&item) {
+		return Emplace(pos, std::move(item));
+	}
+
+	// Удаляет элемент, сдвигая меньшую из частей массива
+	iterator Erase(const_iterator pos) {
+		const size_t pos_index = pos - begin();
+		T *first = begin();
+		if (pos_index < size_ - pos_index - 1) {
+			if constexpr (IsTriviallyRelocatableV<T>) {
+				std::destroy_at(first + pos_index);
+				std::memmove(static_cast<void*>(first + 1), static_cast<const void*>(first), pos_index * sizeof(T));
+			} else {
+				std::move_backward(first, first + pos_index, first + pos_index + 1);
+				std::destroy_at(first);
+			}
+			++front_;
+		} else {
+			if constexpr (IsTriviallyRelocatableV<T>) {
+				std::destroy_at(first + pos_index);
+				std::memmove(static_cast<void*>(first + pos_index), static_cast<const void*>(first + pos_index + 1),
+						(size_ - pos_index - 1) * sizeof(T));
+			} else {
+				std::move(first + pos_index + 1, end(), first + pos_index);
+				std::destroy_at(end() - 1);
+			}
+		}
+		--size_;
+		return begin() + pos_index;
+	}
+
+	void PopBack() noexcept {
+		assert(size_ != 0);
+		std::destroy_at(end() - 1);
+		--size_;
+	}
+
+	void PopFront() noexcept {
+		assert(size_ != 0);
+		std::destroy_at(begin());
+		++front_;
+		--size_;
+	}
+
+	// Разрушает элементы; освободившаяся ёмкость делится между сторонами поровну
+	void Clear() noexcept {
+		std::destroy_n(begin(), size_);
+		size_ = 0;
+		front_ = data_.Capacity() / 2;
+	}
+
+	size_t Size() const noexcept {
+		return size_;
+	}
+
+	size_t Capacity() const noexcept {
+		return data_.Capacity();
+	}
+
+	size_t FrontSpare() const noexcept {
+		return front_;
+	}
+
+	size_t BackSpare() const noexcept {
+		return data_.Capacity() - front_ - size_;
+	}
+
+	const Allocator& GetAllocator() const noexcept {
+		return data_.GetAllocator();
+	}
+
+	T& Front() noexcept {
+		assert(size_ != 0);
+		return *begin();
+	}
+	const T& Front() const noexcept {
+		assert(size_ != 0);
+		return *begin();
+	}
+
+	T& Back() noexcept {
+		assert(size_ != 0);
+		return *(end() - 1);
+	}
+	const T& Back() const noexcept {
+		assert(size_ != 0);
+		return *(end() - 1);
+	}
+
+	T& operator[](size_t index) noexcept {
+		assert(index < size_);
+		return begin()[index];
+	}
+	const T& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return begin()[index];
+	}
+
+	iterator begin() noexcept {
+		return data_.GetAddress() + front_;
+	}
+	iterator end() noexcept {
+		return begin() + size_;
+	}
+	const_iterator begin() const noexcept {
+		return data_.GetAddress() + front_;
+	}
+	const_iterator end() const noexcept {
+		return begin() + size_;
+	}
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	// Сдвигает часть тривиально перемещаемого массива на одну позицию к краю to_front и побайтово
+	// переносит в освободившуюся позицию уже созданный элемент item
+	void ShiftAndRelocate(size_t pos_index, bool to_front, T *item) noexcept {
+		T *first = begin();
+		if (to_front) {
+			std::memmove(static_cast<void*>(first - 1), static_cast<const void*>(first), pos_index * sizeof(T));
+			--front_;
+		} else {
+			std::memmove(static_cast<void*>(first + pos_index + 1), static_cast<const void*>(first + pos_index),
+					(size_ - pos_index) * sizeof(T));
+		}
+		std::memcpy(static_cast<void*>(begin() + pos_index), static_cast<const void*>(item), sizeof(T));
+	}
+
+	// Вставка, когда со стороны to_front запаса нет. Если свободного места в буфере не меньше размера,
+	// ёмкость не растёт: тривиально перемещаемый массив сдвигается внутри буфера, остальные переносятся
+	// в новый буфер той же ёмкости. Три четверти свободного места отдаётся стороне to_front, четверть — другой,
+	// поэтому чередование вставок с разных сторон не вызывает перенос на каждой операции
+	template<typename ... Args>
+	iterator GrowAndEmplace(size_t pos_index, bool to_front, Args &&... args) {
+		const bool keep_capacity = size_ != 0 && data_.Capacity() - size_ >= size_;
+		if constexpr (IsTriviallyRelocatableV<T>) {
+			if (keep_capacity) {
+				// Элемент создаётся до сдвига массива: аргументы могут ссылаться на его элементы
+				alignas(T) unsigned char slot[sizeof(T)];
+				T *item = new (slot) T(std::forward<Args>(args)...);
+				const size_t new_front = SplitSpare(data_.Capacity() - size_, to_front);
+				std::memmove(static_cast<void*>(data_.GetAddress() + new_front), static_cast<const void*>(begin()), size_ * sizeof(T));
+				front_ = new_front;
+				ShiftAndRelocate(pos_index, to_front, item);
+				++size_;
+				return begin() + pos_index;
+			}
+		}
+		RawMemory<T, Allocator> new_data(
+				keep_capacity ? data_.Capacity() : GrowthPolicy::NextCapacity(data_.Capacity(), size_ + 1, sizeof(T)),
+				data_.GetAllocator());
+		const size_t new_front = SplitSpare(new_data.Capacity() - size_ - 1, to_front);
+		T *item = new (new_data.GetAddress() + new_front + pos_index) T(std::forward<Args>(args)...);
+		try {
+			UninitializedRelocateAround(begin(), size_, pos_index, new_data.GetAddress() + new_front);
+		} catch (...) {
+			std::destroy_at(item);
+			throw;
+		}
+		data_.Swap(new_data);
+		front_ = new_front;
+		++size_;
+		return item;
+	}
+
+	// Заменяет элементы count элементами из first. Существующие элементы переприсваиваются,
+	// новый буфер выделяется, только если count больше ёмкости
+	template<typename RandomIt>
+	void AssignFrom(RandomIt first, size_t count) {
+		if (count > data_.Capacity()) {
+			RawMemory<T, Allocator> new_data(count, data_.GetAllocator());
+			std::uninitialized_copy_n(first, count, new_data.GetAddress());
+			Clear();
+			data_.Swap(new_data);
+			front_ = 0;
+		} else if (front_ + count > data_.Capacity()) {
+			// От текущего начала элементы не помещаются: массив заново размещается посередине буфера
+			Clear();
+			front_ = (data_.Capacity() - count) / 2;
+			std::uninitialized_copy_n(first, count, begin());
+		} else if (size_ <= count) {
+			std::copy_n(first, size_, begin());
+			std::uninitialized_copy_n(first + size_, count - size_, end());
+		} else {
+			std::copy_n(first, count, begin());
+			std::destroy_n(begin() + count, size_ - count);
+		}
+		size_ = count;
+	}
+
+	// Запас перед первым элементом при распределении spare свободных позиций
+	static size_t SplitSpare(size_t spare, bool to_front) noexcept {
+		return to_front ? spare - spare / 4 : spare / 4;
+	}
+
+	// Переносит элементы в буфер на new_capacity элементов, начиная с позиции new_front
+	void Reallocate(size_t new_capacity, size_t new_front) {
+		RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+		UninitializedRelocate(begin(), size_, new_data.GetAddress() + new_front);
+		data_.Swap(new_data);
+		front_ = new_front;
+	}
+
+	RawMemory<T, Allocator> data_;
+	// Число свободных позиций перед первым элементом
+	size_t front_ = 0;
+	size_t size_ = 0;
+};
@@ -0,0 +1,624 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace flat_detail {
+
+// Бинарный поиск без ветвлений: индекс первого из count элементов, для которого before(x) ложно
+// (элементы, для которых before истинно, должны идти в начале). На каждом шаге диапазон сокращается
+// вдвое, а выбор половины компилируется в условное присваивание, поэтому время поиска не зависит
+// от предсказания переходов
+template<typename T, typename Before>
+size_t PartitionPoint(const T *items, size_t count, Before before) {
+	if (count == 0) {
+		return 0;
+	}
+	const T *base = items;
+	while (count > 1) {
+		const size_t half = count / 2;
+		base = before(base[half]) ? base + half : base;
+		count -= half;
+	}
+	return static_cast<size_t>(base - items) + (before(*base) ? 1 : 0);
+}
+
+template<typename K, typename Compare>
+size_t LowerBound(const K *keys, size_t count, const K &key, const Compare &comp) {
+	return PartitionPoint(keys, count, [&key, &comp](const K &item) {
+		return comp(item, key);
+	});
+}
+
+template<typename K, typename Compare>
+size_t UpperBound(const K *keys, size_t count, const K &key, const Compare &comp) {
+	return PartitionPoint(keys, count, [&key, &comp](const K &item) {
+		return !comp(key, item);
+	});
+}
+
+// Сортирует элементы по ключу key_of(x) и удаляет повторы, оставляя первое вхождение каждого ключа
+template<typename Item, typename Allocator, typename KeyOf, typename Compare>
+void SortUnique(Vector<Item, Allocator> &items, KeyOf key_of, const Compare &comp) {
+	const auto less = [&key_of, &comp](const Item &lhs, const Item &rhs) {
+		return comp(key_of(lhs), key_of(rhs));
+	};
+	std::stable_sort(items.begin(), items.end(), less);
+	const auto last = std::unique(items.begin(), items.end(), [&less](const Item &lhs, const Item &rhs) {
+		return !less(lhs, rhs);
+	});
+	items.Erase(last, items.end());
+}
+
+}  // namespace flat_detail
+
+// Упорядоченное множество на отсортированном Vector. Ключи лежат подряд, поэтому поиск — бинарный
+// без ветвлений по непрерывному массиву, без переходов по разбросанным узлам, как у std::set.
+// Вставка и удаление одного ключа сдвигают хвост за O(n); диапазон ключей Insert(first, last)
+// сортирует отдельно и сливает с множеством за один проход
+template<typename K, typename Compare = std::less<K>, typename Allocator = std::allocator<K>>
+class FlatSet {
+public:
+	using iterator = typename Vector<K, Allocator>::const_iterator;
+	using const_iterator = iterator;
+
+	FlatSet() = default;
+
+	explicit FlatSet(const Compare &comp, const Allocator &alloc = Allocator()) :
+			keys_(alloc), comp_(comp) {
+	}
+
+	// Строит множество из диапазона сортировкой и удалением повторов
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	FlatSet(InputIt first, InputIt last, const Compare &comp = Compare(), const Allocator &alloc = Allocator()) :
+			keys_(alloc), comp_(comp) {
+		Insert(first, last);
+	}
+
+	FlatSet(std::initializer_list<K> keys, const Compare &comp = Compare(), const Allocator &alloc = Allocator()) :
+			FlatSet(keys.begin(), keys.end(), comp, alloc) {
+	}
+
+	std::pair<iterator, bool> Insert(const K &key) {
+		return InsertOne(key);
+	}
+	std::pair<iterator, bool> Insert(K &&key) {
+		return InsertOne(std::move(key));
+	}
+
+	// Вставляет ключи диапазона за O(n + m log m) вместо m сдвигов хвоста. Уже присутствующие ключи
+	// не меняются. Если перемещение ключей не бросает, при исключении множество не меняется
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	void Insert(InputIt first, InputIt last) {
+		Vector<K, Allocator> batch(keys_.GetAllocator());
+		batch.Append(first, last);
+		flat_detail::SortUnique(batch, [](const K &key) -> const K& {
+			return key;
+		}, comp_);
+		Merge(std::move(batch));
+	}
+
+	void Insert(std::initializer_list<K> keys) {
+		Insert(keys.begin(), keys.end());
+	}
+
+	size_t Erase(const K &key) {
+		const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+		if (index == keys_.Size() || comp_(key, keys_[index])) {
+			return 0;
+		}
+		keys_.Erase(keys_.begin() + index);
+		return 1;
+	}
+
+	iterator Erase(const_iterator pos) {
+		return keys_.Erase(pos);
+	}
+
+	template<typename Predicate>
+	size_t EraseIf(Predicate pred) {
+		return keys_.EraseIf(pred);
+	}
+
+	iterator Find(const K &key) const {
+		const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+		return index != keys_.Size() && !comp_(key, keys_[index]) ? begin() + index : end();
+	}
+
+	bool Contains(const K &key) const {
+		return Find(key) != end();
+	}
+
+	size_t Count(const K &key) const {
+		return Contains(key) ? 1 : 0;
+	}
+
+	iterator LowerBound(const K &key) const {
+		return begin() + flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+	}
+
+	iterator UpperBound(const K &key) const {
+		return begin() + flat_detail::UpperBound(keys_.Data(), keys_.Size(), key, comp_);
+	}
+
+	void Reserve(size_t capacity) {
+		keys_.Reserve(capacity);
+	}
+
+	void ShrinkToFit() {
+		keys_.ShrinkToFit();
+	}
+
+	void Clear() noexcept {
+		keys_.Clear();
+	}
+
+	size_t Size() const noexcept {
+		return keys_.Size();
+	}
+
+	// Ключи в порядке возрастания
+	const Vector<K, Allocator>& Keys() const noexcept {
+		return keys_;
+	}
+
+	iterator begin() const noexcept {
+		return keys_.begin();
+	}
+	iterator end() const noexcept {
+		return keys_.end();
+	}
+	iterator cbegin() const noexcept {
+		return begin();
+	}
+	iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	template<typename M>
+	std::pair<iterator, bool> InsertOne(M &&key) {
+		const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), static_cast<const K&>(key), comp_);
+		if (index != keys_.Size() && !comp_(key, keys_[index])) {
+			return {begin() + index, false};
+		}
+		return {keys_.Emplace(keys_.begin() + index, std::forward<M>(key)), true};
+	}
+
+	// Сливает отсортированную пачку без повторов с ключами множества
+	void Merge(Vector<K, Allocator> &&batch) {
+		const size_t size = keys_.Size();
+		if (batch.Size() == 0) {
+			return;
+		}
+		if (size == 0) {
+			keys_ = std::move(batch);
+			return;
+		}
+		if (comp_(keys_[size - 1], batch[0])) {
+			// Пачка целиком больше последнего ключа: достаточно дописать её в конец
+			keys_.Append(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+			return;
+		}
+		Vector<K, Allocator> merged(keys_.GetAllocator());
+		merged.Reserve(size + batch.Size());
+		size_t i = 0;
+		size_t j = 0;
+		while (i != size && j != batch.Size()) {
+			if (comp_(batch[j], keys_[i])) {
+				merged.PushBack(std::move(batch[j++]));
+			} else {
+				if (!comp_(keys_[i], batch[j])) {
+					// Ключ уже есть: остаётся прежний
+					++j;
+				}
+				merged.PushBack(std::move(keys_[i++]));
+			}
+		}
+		for (; i != size; ++i) {
+			merged.PushBack(std::move(keys_[i]));
+		}
+		for (; j != batch.Size(); ++j) {
+			merged.PushBack(std::move(batch[j]));
+		}
+		keys_ = std::move(merged);
+	}
+
+	Vector<K, Allocator> keys_;
+	[[no_unique_address]] Compare comp_;
+};
+
+// Упорядоченный словарь на двух параллельных Vector: ключи отдельно от значений, поэтому поиск читает
+// только плотный массив ключей и не тянет значения в кэш. Итератор разыменовывается в пару ссылок
+// std::pair<const K&, V&>. Сложность операций — как у FlatSet
+template<typename K, typename V, typename Compare = std::less<K>, typename KeyAllocator = std::allocator<K>,
+		typename ValueAllocator = std::allocator<V>>
+class FlatMap {
+	template<bool kConst>
+	class Iterator {
+		using ValuePointer = std::conditional_t<kConst, const V*, V*>;
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::pair<K, V>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<const K&, std::conditional_t<kConst, const V&, V&>>;
+
+		// Пара ссылок создаётся при разыменовании, поэтому operator-> возвращает её внутри обёртки
+		struct pointer {
+			const reference* operator->() const noexcept {
+				return &item;
+			}
+			reference item;
+		};
+
+		Iterator() = default;
+
+		Iterator(const K *key, ValuePointer value) noexcept :
+				key_(key), value_(value) {
+		}
+
+		template<bool kOther, std::enable_if_t<kConst && !kOther, int> = 0>
+		Iterator(const Iterator<kOther> &other) noexcept :
+				key_(other.key_), value_(other.value_) {
+		}
+
+		reference operator*() const noexcept {
+			return {*key_, *value_};
+		}
+		pointer operator->() const noexcept {
+			return {**this};
+		}
+		reference operator[](difference_type offset) const noexcept {
+			return {key_[offset], value_[offset]};
+		}
+
+		Iterator& operator++() noexcept {
+			++key_;
+			++value_;
+			return *this;
+		}
+		Iterator operator++(int) noexcept {
+			Iterator old = *this;
+			++*this;
+			return old;
+		}
+		Iterator& operator--() noexcept {
+			--key_;
+			--value_;
+			return *this;
+		}
+		Iterator operator--(int) noexcept {
+			Iterator old = *this;
+			--*this;
+			return old;
+		}
+		Iterator& operator+=(difference_type offset) noexcept {
+			key_ += offset;
+			value_ += offset;
+			return *this;
+		}
+		Iterator& operator-=(difference_type offset) noexcept {
+			return *this += -offset;
+		}
+		Iterator operator+(difference_type offset) const noexcept {
+			return Iterator(*this) += offset;
+		}
+		friend Iterator operator+(difference_type offset, const Iterator &it) noexcept {
+			return it + offset;
+		}
+		Iterator operator-(difference_type offset) const noexcept {
+			return Iterator(*this) -= offset;
+		}
+		difference_type operator-(const Iterator &other) const noexcept {
+			return key_ - other.key_;
+		}
+
+		bool operator==(const Iterator &other) const noexcept {
+			return key_ == other.key_;
+		}
+		auto operator<=>(const Iterator &other) const noexcept {
+			return key_ <=> other.key_;
+		}
+
+	private:
+		template<bool>
+		friend class Iterator;
+		friend class FlatMap;
+
+		const K *key_ = nullptr;
+		ValuePointer value_ = nullptr;
+	};
+
+	using Item = std::pair<K, V>;
+	// Пачка вставляемых пар размещается аллокатором ключей
+	using Batch = Vector<Item, typename std::allocator_traits<KeyAllocator>::template rebind_alloc<Item>>;
+
+public:
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	FlatMap() = default;
+
+	explicit FlatMap(const Compare &comp, const KeyAllocator &key_alloc = KeyAllocator(),
+			const ValueAllocator &value_alloc = ValueAllocator()) :
+			keys_(key_alloc), values_(value_alloc), comp_(comp) {
+	}
+
+	// Строит словарь из диапазона пар: сортировка, затем удаление повторов ключа (остаётся первая пара)
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	FlatMap(InputIt first, InputIt last, const Compare &comp = Compare(), const KeyAllocator &key_alloc = KeyAllocator(),
+			const ValueAllocator &value_alloc = ValueAllocator()) :
+			keys_(key_alloc), values_(value_alloc), comp_(comp) {
+		Insert(first, last);
+	}
+
+	FlatMap(std::initializer_list<Item> items, const Compare &comp = Compare(), const KeyAllocator &key_alloc = KeyAllocator(),
+			const ValueAllocator &value_alloc = ValueAllocator()) :
+			FlatMap(items.begin(), items.end(), comp, key_alloc, value_alloc) {
+	}
+
+	// Создаёт значение из args, если ключа ещё нет
+	template<typename ... Args>
+	std::pair<iterator, bool> TryEmplace(const K &key, Args &&... args) {
+		return EmplaceOne(key, std::forward<Args>(args)...);
+	}
+	template<typename ... Args>
+	std::pair<iterator, bool> TryEmplace(K &&key, Args &&... args) {
+		return EmplaceOne(std::move(key), std::forward<Args>(args)...);
+	}
+
+	template<typename M>
+	std::pair<iterator, bool> InsertOrAssign(const K &key, M &&value) {
+		auto [it, inserted] = TryEmplace(key, std::forward<M>(value));
+		if (!inserted) {
+			it->second = std::forward<M>(value);
+		}
+		return {it, inserted};
+	}
+
+	std::pair<iterator, bool> Insert(const Item &item) {
+		return TryEmplace(item.first, item.second);
+	}
+	std::pair<iterator, bool> Insert(Item &&item) {
+		return TryEmplace(std::move(item.first), std::move(item.second));
+	}
+
+	// Вставляет пары диапазона за O(n + m log m): пачка сортируется отдельно и сливается со словарём
+	// за один проход. Значения уже присутствующих ключей не меняются. Если перемещение ключей и значений
+	// не бросает, при исключении словарь не меняется
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	void Insert(InputIt first, InputIt last) {
+		Batch batch(keys_.GetAllocator());
+		batch.Append(first, last);
+		flat_detail::SortUnique(batch, [](const Item &item) -> const K& {
+			return item.first;
+		}, comp_);
+		Merge(std::move(batch));
+	}
+
+	void Insert(std::initializer_list<Item> items) {
+		Insert(items.begin(), items.end());
+	}
+
+	V& operator[](const K &key) {
+		return TryEmplace(key).first->second;
+	}
+	V& operator[](K &&key) {
+		return TryEmplace(std::move(key)).first->second;
+	}
+
+	V& At(const K &key) {
+		return const_cast<V&>(std::as_const(*this).At(key));
+	}
+
+	const V& At(const K &key) const {
+		const size_t index = IndexOf(key);
+		if (index == keys_.Size()) {
+			throw std::out_of_range("FlatMap key not found");
+		}
+		return values_[index];
+	}
+
+	size_t Erase(const K &key) {
+		const size_t index = IndexOf(key);
+		if (index == keys_.Size()) {
+			return 0;
+		}
+		EraseAt(index);
+		return 1;
+	}
+
+	iterator Erase(const_iterator pos) {
+		const size_t index = pos.key_ - keys_.Data();
+		EraseAt(index);
+		return MakeIterator(index);
+	}
+
+	iterator Find(const K &key) {
+		return MakeIterator(IndexOf(key));
+	}
+
+	const_iterator Find(const K &key) const {
+		return MakeIterator(IndexOf(key));
+	}
+
+	bool Contains(const K &key) const {
+		return IndexOf(key) != keys_.Size();
+	}
+
+	size_t Count(const K &key) const {
+		return Contains(key) ? 1 : 0;
+	}
+
+	iterator LowerBound(const K &key) {
+		return MakeIterator(flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_));
+	}
+	const_iterator LowerBound(const K &key) const {
+		return MakeIterator(flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_));
+	}
+
+	iterator UpperBound(const K &key) {
+		return MakeIterator(flat_detail::UpperBound(keys_.Data(), keys_.Size(), key, comp_));
+	}
+	const_iterator UpperBound(const K &key) const {
+		return MakeIterator(flat_detail::UpperBound(keys_.Data(), keys_.Size(), key, comp_));
+	}
+
+	void Reserve(size_t capacity) {
+		keys_.Reserve(capacity);
+		values_.Reserve(capacity);
+	}
+
+	void ShrinkToFit() {
+		keys_.ShrinkToFit();
+		values_.ShrinkToFit();
+	}
+
+	void Clear() noexcept {
+		keys_.Clear();
+		values_.Clear();
+	}
+
+	size_t Size() const noexcept {
+		return keys_.Size();
+	}
+
+	// Ключи в порядке возрастания и соответствующие им значения
+	const Vector<K, KeyAllocator>& Keys() const noexcept {
+		return keys_;
+	}
+	const Vector<V, ValueAllocator>& Values() const noexcept {
+		return values_;
+	}
+
+	iterator begin() noexcept {
+		return MakeIterator(0);
+	}
+	iterator end() noexcept {
+		return MakeIterator(keys_.Size());
+	}
+	const_iterator begin() const noexcept {
+		return MakeIterator(0);
+	}
+	const_iterator end() const noexcept {
+		return MakeIterator(keys_.Size());
+	}
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	iterator MakeIterator(size_t index) noexcept {
+		return iterator(keys_.Data() + index, values_.Data() + index);
+	}
+	const_iterator MakeIterator(size_t index) const noexcept {
+		return const_iterator(keys_.Data() + index, values_.Data() + index);
+	}
+
+	// Индекс ключа key или Size(), если его нет
+	size_t IndexOf(const K &key) const {
+		const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+		return index != keys_.Size() && !comp_(key, keys_[index]) ? index : keys_.Size();
+	}
+
+	void EraseAt(size_t index) {
+		keys_.Erase(keys_.begin() + index);
+		values_.Erase(values_.begin() + index);
+	}
+
+	template<typename M, typename ... Args>
+	std::pair<iterator, bool> EmplaceOne(M &&key, Args &&... args) {
+		const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), static_cast<const K&>(key), comp_);
+		if (index != keys_.Size() && !comp_(key, keys_[index])) {
+			return {MakeIterator(index), false};
+		}
+		// Значение создаётся первым: args могут ссылаться на значения словаря, которые сдвинет вставка ключа
+		values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+		try {
+			keys_.Emplace(keys_.begin() + index, std::forward<M>(key));
+		} catch (...) {
+			values_.Erase(values_.begin() + index);
+			throw;
+		}
+		return {MakeIterator(index), true};
+	}
+
+	// Сливает отсортированную пачку без повторов ключа со словарём
+	void Merge(Batch &&batch) {
+		const size_t size = keys_.Size();
+		if (batch.Size() == 0) {
+			return;
+		}
+		if (size != 0 && !comp_(keys_[size - 1], batch[0].first)) {
+			MergeInto(std::move(batch));
+			return;
+		}
+		// Словарь пуст или пачка целиком больше последнего ключа: пары дописываются в конец
+		keys_.Reserve(size + batch.Size());
+		values_.Reserve(size + batch.Size());
+		for (Item &item : batch) {
+			keys_.PushBack(std::move(item.first));
+			try {
+				values_.PushBack(std::move(item.second));
+			} catch (...) {
+				keys_.PopBack();
+				throw;
+			}
+		}
+	}
+
+	void MergeInto(Batch &&batch) {
+		const size_t size = keys_.Size();
+		Vector<K, KeyAllocator> keys(keys_.GetAllocator());
+		Vector<V, ValueAllocator> values(values_.GetAllocator());
+		keys.Reserve(size + batch.Size());
+		values.Reserve(size + batch.Size());
+		size_t i = 0;
+		size_t j = 0;
+		const auto take_own = [&] {
+			keys.PushBack(std::move(keys_[i]));
+			values.PushBack(std::move(values_[i]));
+			++i;
+		};
+		const auto take_batch = [&] {
+			keys.PushBack(std::move(batch[j].first));
+			values.PushBack(std::move(batch[j].second));
+			++j;
+		};
+		while (i != size && j != batch.Size()) {
+			if (comp_(batch[j].first, keys_[i])) {
+				take_batch();
+			} else {
+				if (!comp_(keys_[i], batch[j].first)) {
+					// Ключ уже есть: остаётся прежнее значение
+					++j;
+				}
+				take_own();
+			}
+		}
+		while (i != size) {
+			take_own();
+		}
+		while (j != batch.Size()) {
+			take_batch();
+		}
+		keys_ = std::move(keys);
+		values_ = std::move(values);
+	}
+
+	Vector<K, KeyAllocator> keys_;
+	Vector<V, ValueAllocator> values_;
+	[[no_unique_address]] Compare comp_;
+};
@@ -0,0 +1,269 @@
+#pragma once
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vector.h"
+
+// Ожидаемый порядок обращения к элементам MappedVector
+enum class MappedAccess {
+	kSequential,
+	kRandom,
+	kWillNeed
+};
+
+// Вектор тривиально копируемых записей, хранящийся в файле, отображённом в память (POSIX).
+// Файл — просто массив записей без заголовка, поэтому открытие существующего файла не копирует данные,
+// а изменения попадают в файл без явного сохранения. Ёмкость растёт по GrowthPolicy: файл удлиняется
+// через ftruncate и отображается заново, указатели и ссылки на элементы при этом становятся
+// недействительными. Пока вектор открыт, длина файла равна ёмкости с округлением до страницы;
+// при закрытии файл обрезается до Size() записей. Ошибки системных вызовов бросают std::system_error
+template<typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+	static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires a trivially copyable element type");
+
+public:
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	MappedVector() = default;
+
+	// Открывает файл path для чтения и записи, создавая его при отсутствии
+	explicit MappedVector(const std::string &path) :
+			fd_(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)) {
+		if (fd_ < 0) {
+			ThrowSystemError("open");
+		}
+		struct stat info;
+		if (::fstat(fd_, &info) != 0) {
+			const int error = errno;
+			::close(fd_);
+			throw std::system_error(error, std::generic_category(), "fstat");
+		}
+		const size_t bytes = static_cast<size_t>(info.st_size);
+		if (bytes % sizeof(T) != 0) {
+			::close(fd_);
+			throw std::runtime_error("MappedVector: file size is not a multiple of the element size");
+		}
+		size_ = capacity_ = bytes / sizeof(T);
+		if (bytes != 0) {
+			void *address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+			if (address == MAP_FAILED) {
+				const int error = errno;
+				::close(fd_);
+				throw std::system_error(error, std::generic_category(), "mmap");
+			}
+			data_ = static_cast<T*>(address);
+			mapped_bytes_ = bytes;
+		}
+	}
+
+	MappedVector(const MappedVector&) = delete;
+	MappedVector& operator=(const MappedVector&) = delete;
+
+	MappedVector(MappedVector &&other) noexcept {
+		Swap(other);
+	}
+
+	MappedVector& operator=(MappedVector &&other) noexcept {
+		if (this != &other) {
+			Close();
+			Swap(other);
+		}
+		return *this;
+	}
+
+	~MappedVector() {
+		Close();
+	}
+
+	void Swap(MappedVector &other) noexcept {
+		std::swap(fd_, other.fd_);
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+		std::swap(mapped_bytes_, other.mapped_bytes_);
+	}
+
+	bool IsOpen() const noexcept {
+		return fd_ >= 0;
+	}
+
+	void Reserve(size_t new_capacity) {
+		assert(IsOpen());
+		if (new_capacity <= capacity_) {
+			return;
+		}
+		const size_t bytes = RoundUpToPage(new_capacity * sizeof(T));
+		if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+			ThrowSystemError("ftruncate");
+		}
+		Remap(bytes);
+		capacity_ = bytes / sizeof(T);
+	}
+
+	void Resize(size_t new_size) {
+		if (new_size > size_) {
+			Reserve(new_size);
+			std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+		}
+		size_ = new_size;
+	}
+
+	void PushBack(const T &value) {
+		EmplaceBack(value);
+	}
+
+	template<typename ... Args>
+	T& EmplaceBack(Args &&... args) {
+		if (size_ == capacity_) {
+			// Аргументы могут ссылаться на элемент вектора, а Reserve отображает файл заново
+			T value(std::forward<Args>(args)...);
+			Reserve(GrowthPolicy::NextCapacity(capacity_, size_ + 1, sizeof(T)));
+			return *new (data_ + size_++) T(value);
+		}
+		return *new (data_ + size_++) T(std::forward<Args>(args)...);
+	}
+
+	void PopBack() noexcept {
+		assert(size_ != 0);
+		--size_;
+	}
+
+	void Clear() noexcept {
+		size_ = 0;
+	}
+
+	// Синхронно записывает изменённые страницы на диск
+	void Sync() {
+		if (mapped_bytes_ != 0 && ::msync(data_, mapped_bytes_, MS_SYNC) != 0) {
+			ThrowSystemError("msync");
+		}
+	}
+
+	// Подсказывает ядру, как будут читаться данные: упреждающее чтение для последовательного прохода,
+	// его отключение для случайного доступа или немедленная подгрузка всего файла
+	void Advise(MappedAccess access) {
+		if (mapped_bytes_ == 0) {
+			return;
+		}
+		int advice = MADV_NORMAL;
+		switch (access) {
+		case MappedAccess::kSequential:
+			advice = MADV_SEQUENTIAL;
+			break;
+		case MappedAccess::kRandom:
+			advice = MADV_RANDOM;
+			break;
+		case MappedAccess::kWillNeed:
+			advice = MADV_WILLNEED;
+			break;
+		}
+		if (::madvise(data_, mapped_bytes_, advice) != 0) {
+			ThrowSystemError("madvise");
+		}
+	}
+
+	size_t Size() const noexcept {
+		return size_;
+	}
+
+	size_t Capacity() const noexcept {
+		return capacity_;
+	}
+
+	T& operator[](size_t index) noexcept {
+		assert(index < size_);
+		return data_[index];
+	}
+
+	const T& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return data_[index];
+	}
+
+	iterator begin() noexcept {
+		return data_;
+	}
+	iterator end() noexcept {
+		return data_ + size_;
+	}
+	const_iterator begin() const noexcept {
+		return data_;
+	}
+	const_iterator end() const noexcept {
+		return data_ + size_;
+	}
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	[[noreturn]] static void ThrowSystemError(const char *what) {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	static size_t RoundUpToPage(size_t bytes) noexcept {
+		static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+		return (bytes + page_size - 1) / page_size * page_size;
+	}
+
+	// Отображает первые bytes байт файла вместо текущего отображения
+	void Remap(size_t bytes) {
+		void *address;
+		const char *call = "mmap";
+		if (mapped_bytes_ == 0) {
+			address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+		} else {
+#if defined(__linux__)
+			address = ::mremap(data_, mapped_bytes_, bytes, MREMAP_MAYMOVE);
+			call = "mremap";
+#else
+			address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+			if (address != MAP_FAILED) {
+				::munmap(data_, mapped_bytes_);
+			}
+#endif
+		}
+		if (address == MAP_FAILED) {
+			ThrowSystemError(call);
+		}
+		data_ = static_cast<T*>(address);
+		mapped_bytes_ = bytes;
+	}
+
+	// Снимает отображение и обрезает файл до фактического размера
+	void Close() noexcept {
+		if (fd_ < 0) {
+			return;
+		}
+		if (mapped_bytes_ != 0) {
+			::munmap(data_, mapped_bytes_);
+		}
+		[[maybe_unused]] int result = ::ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T)));
+		::close(fd_);
+		fd_ = -1;
+		data_ = nullptr;
+		size_ = capacity_ = mapped_bytes_ = 0;
+	}
+
+	int fd_ = -1;
+	T *data_ = nullptr;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+	size_t mapped_bytes_ = 0;
+};
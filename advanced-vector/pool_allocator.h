@@ -0,0 +1,223 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "vector.h"
+
+// Пул блоков памяти с классами размеров по степеням двойки (от 16 байт до 1 МиБ).
+// У каждого потока свой кэш свободных блоков, поэтому выделение и освобождение обычно не берут блокировок
+// и не обращаются к общей куче. Кэш потока ограничен: излишки пачками уходят в общий для всех потоков
+// список класса, откуда их забирают потоки с пустым кэшем. Блок, выделенный в одном потоке, можно
+// освободить в любом другом. Блоки крупнее 1 МиБ выделяются напрямую через operator new
+class ThreadCachingPool {
+public:
+	static constexpr size_t kMinBlockSize = 16;
+	static constexpr size_t kMaxBlockSize = size_t(1) << 20;
+	// Сколько байт одного класса размеров может лежать в кэше потока
+	static constexpr size_t kMaxCachedBytes = size_t(256) << 10;
+
+	static void* Allocate(size_t bytes) {
+		if (bytes > kMaxBlockSize) {
+			return operator new(bytes);
+		}
+		const size_t index = ClassIndex(bytes);
+		ThreadCache *cache = LocalCache();
+		if (cache == nullptr) [[unlikely]] {
+			return AllocateShared(index);
+		}
+		FreeList &local = cache->lists[index];
+		if (local.head == nullptr) {
+			Refill(index, local);
+			if (local.head == nullptr) {
+				return operator new(BlockSize(index));
+			}
+		}
+		return local.Pop();
+	}
+
+	static void Deallocate(void *p, size_t bytes) noexcept {
+		if (bytes > kMaxBlockSize) {
+			operator delete(p);
+			return;
+		}
+		const size_t index = ClassIndex(bytes);
+		ThreadCache *cache = LocalCache();
+		if (cache == nullptr) [[unlikely]] {
+			CentralList &central = Central(index);
+			std::lock_guard lock(central.mutex);
+			central.list.Push(p);
+			return;
+		}
+		FreeList &local = cache->lists[index];
+		local.Push(p);
+		if (local.count > MaxCachedBlocks(index)) {
+			Spill(index, local, local.count / 2);
+		}
+	}
+
+	// Размер блока, который фактически выделяется под запрос в bytes байт
+	static size_t UsableSize(size_t bytes) noexcept {
+		return bytes > kMaxBlockSize ? bytes : BlockSize(ClassIndex(bytes));
+	}
+
+private:
+	static constexpr size_t kClassCount = std::bit_width(kMaxBlockSize / kMinBlockSize);
+
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	struct FreeList {
+		void Push(void *p) noexcept {
+			auto *block = static_cast<FreeBlock*>(p);
+			block->next = head;
+			head = block;
+			++count;
+		}
+
+		void* Pop() noexcept {
+			FreeBlock *block = head;
+			head = block->next;
+			--count;
+			return block;
+		}
+
+		FreeBlock *head = nullptr;
+		size_t count = 0;
+	};
+
+	struct CentralList {
+		std::mutex mutex;
+		FreeList list;
+	};
+
+	struct ThreadCache {
+		~ThreadCache() {
+			CacheDestroyed() = true;
+			for (size_t index = 0; index < kClassCount; ++index) {
+				Spill(index, lists[index], lists[index].count);
+			}
+		}
+
+		FreeList lists[kClassCount];
+	};
+
+	static size_t ClassIndex(size_t bytes) noexcept {
+		return bytes <= kMinBlockSize ? 0 : std::bit_width((bytes - 1) / kMinBlockSize);
+	}
+
+	static size_t BlockSize(size_t index) noexcept {
+		return kMinBlockSize << index;
+	}
+
+	static size_t MaxCachedBlocks(size_t index) noexcept {
+		return std::max<size_t>(kMaxCachedBytes / BlockSize(index), 2);
+	}
+
+	// Кэш потока или nullptr, если он уже разрушен: деструкторы других thread_local и статических
+	// объектов, выполняющиеся после него, работают с общими списками напрямую
+	static ThreadCache* LocalCache() {
+		if (CacheDestroyed()) [[unlikely]] {
+			return nullptr;
+		}
+		thread_local ThreadCache cache;
+		return &cache;
+	}
+
+	// Флаг без деструктора доступен на всём протяжении завершения потока
+	static bool& CacheDestroyed() noexcept {
+		thread_local bool destroyed = false;
+		return destroyed;
+	}
+
+	// Общие списки не разрушаются, чтобы потоки, завершающиеся после main, могли вернуть в них блоки
+	static CentralList& Central(size_t index) {
+		static CentralList *central = new CentralList[kClassCount];
+		return central[index];
+	}
+
+	// Переносит count блоков из кэша потока в общий список
+	static void Spill(size_t index, FreeList &local, size_t count) noexcept {
+		if (count == 0) {
+			return;
+		}
+		CentralList &central = Central(index);
+		std::lock_guard lock(central.mutex);
+		for (size_t i = 0; i < count; ++i) {
+			central.list.Push(local.Pop());
+		}
+	}
+
+	// Выделение в обход кэша потока: блок берётся из общего списка или из кучи
+	static void* AllocateShared(size_t index) {
+		{
+			CentralList &central = Central(index);
+			std::lock_guard lock(central.mutex);
+			if (central.list.head != nullptr) {
+				return central.list.Pop();
+			}
+		}
+		return operator new(BlockSize(index));
+	}
+
+	// Забирает из общего списка до половины лимита кэша потока
+	static void Refill(size_t index, FreeList &local) {
+		CentralList &central = Central(index);
+		std::lock_guard lock(central.mutex);
+		const size_t count = std::min(central.list.count, MaxCachedBlocks(index) / 2);
+		for (size_t i = 0; i < count; ++i) {
+			local.Push(central.list.Pop());
+		}
+	}
+};
+
+// Аллокатор поверх ThreadCachingPool. Сообщает Vector реальный размер блока через usable_size,
+// так что ёмкость вектора сразу занимает весь класс размеров
+template<typename T>
+class PoolAllocator {
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "PoolAllocator cannot satisfy alignment of T");
+
+	PoolAllocator() = default;
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>&) noexcept {
+	}
+
+	T* allocate(size_t n) {
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+		return static_cast<T*>(ThreadCachingPool::Allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T *p, size_t n) noexcept {
+		ThreadCachingPool::Deallocate(p, n * sizeof(T));
+	}
+
+	size_t usable_size(T*, size_t n) const noexcept {
+		return ThreadCachingPool::UsableSize(n * sizeof(T)) / sizeof(T);
+	}
+
+	template<typename U>
+	bool operator==(const PoolAllocator<U>&) const noexcept {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const PoolAllocator<U>&) const noexcept {
+		return false;
+	}
+};
+
+// Vector, чьи буферы берутся из потокового кэша ThreadCachingPool
+template<typename T>
+using PooledVector = Vector<T, PoolAllocator<T>>;
@@ -0,0 +1,412 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace ring_detail {
+
+inline size_t RoundUpCapacity(size_t capacity) noexcept {
+	return capacity == 0 ? 0 : std::bit_ceil(capacity);
+}
+
+// Копирует count элементов в кольцо buffer (маска mask), начиная с позиции position
+template<typename T>
+void CopyIn(T *buffer, size_t mask, size_t position, const T *source, size_t count) {
+	const size_t offset = position & mask;
+	const size_t first = std::min(count, mask + 1 - offset);
+	std::uninitialized_copy_n(source, first, buffer + offset);
+	try {
+		std::uninitialized_copy_n(source + first, count - first, buffer);
+	} catch (...) {
+		std::destroy_n(buffer + offset, first);
+		throw;
+	}
+}
+
+// Копирует count тривиально копируемых элементов кольца, начиная с позиции position, в dest
+template<typename T>
+void CopyOut(const T *buffer, size_t mask, size_t position, T *dest, size_t count) noexcept {
+	static_assert(std::is_trivially_copyable_v<T>);
+	// У буфера без ёмкости buffer нулевой, а memcpy с нулевым указателем — UB даже для 0 байт
+	if (count == 0) {
+		return;
+	}
+	const size_t offset = position & mask;
+	const size_t first = std::min(count, mask + 1 - offset);
+	std::memcpy(static_cast<void*>(dest), static_cast<const void*>(buffer + offset), first * sizeof(T));
+	std::memcpy(static_cast<void*>(dest + first), static_cast<const void*>(buffer), (count - first) * sizeof(T));
+}
+
+}  // namespace ring_detail
+
+// Кольцевая очередь на RawMemory для одного потока. Ёмкость — степень двойки, поэтому позиция
+// в буфере вычисляется маской, а не делением. head_ и tail_ только растут, их разность — размер.
+// TryPush не выходит за ёмкость и сообщает о переполнении, PushBack/EmplaceBack при заполнении
+// удваивают буфер
+template<typename T, typename Allocator = std::allocator<T>>
+class RingBuffer {
+public:
+	RingBuffer() = default;
+
+	explicit RingBuffer(size_t capacity, const Allocator &alloc = Allocator()) :
+			data_(ring_detail::RoundUpCapacity(capacity), alloc), capacity_(ring_detail::RoundUpCapacity(capacity)) {
+	}
+
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+
+	RingBuffer(RingBuffer &&other) noexcept :
+			data_(std::move(other.data_)), capacity_(std::exchange(other.capacity_, 0)),
+			head_(std::exchange(other.head_, 0)), tail_(std::exchange(other.tail_, 0)) {
+	}
+
+	RingBuffer& operator=(RingBuffer &&other) noexcept {
+		if (this != &other) {
+			Clear();
+			data_ = std::move(other.data_);
+			capacity_ = std::exchange(other.capacity_, 0);
+			head_ = std::exchange(other.head_, 0);
+			tail_ = std::exchange(other.tail_, 0);
+		}
+		return *this;
+	}
+
+	~RingBuffer() {
+		Clear();
+	}
+
+	// Увеличивает ёмкость до степени двойки не меньше capacity
+	void Reserve(size_t capacity) {
+		if (capacity > Capacity()) {
+			Relocate(ring_detail::RoundUpCapacity(capacity));
+		}
+	}
+
+	template<typename ... Args>
+	bool TryEmplace(Args &&... args) {
+		if (Full()) {
+			return false;
+		}
+		new (Slot(tail_)) T(std::forward<Args>(args)...);
+		++tail_;
+		return true;
+	}
+
+	template<typename M>
+	bool TryPush(M &&value) {
+		return TryEmplace(std::forward<M>(value));
+	}
+
+	template<typename ... Args>
+	T& EmplaceBack(Args &&... args) {
+		if (Full()) {
+			// Аргументы могут ссылаться на элемент очереди, поэтому он создаётся до переноса
+			T value(std::forward<Args>(args)...);
+			Relocate(Capacity() == 0 ? 1 : Capacity() * 2);
+			return *new (Slot(tail_++)) T(std::move(value));
+		}
+		return *new (Slot(tail_++)) T(std::forward<Args>(args)...);
+	}
+
+	template<typename M>
+	void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
+	}
+
+	// Копирует в очередь столько элементов items, сколько помещается без роста, и возвращает их число
+	size_t PushBatch(std::span<const T> items) {
+		const size_t count = std::min(items.size(), Capacity() - Size());
+		if (count != 0) {
+			ring_detail::CopyIn(data_.GetAddress(), Mask(), tail_, items.data(), count);
+			tail_ += count;
+		}
+		return count;
+	}
+
+	// Перемещает первый элемент в out. Возвращает false для пустой очереди
+	bool TryPop(T &out) {
+		if (Empty()) {
+			return false;
+		}
+		T &item = *Slot(head_);
+		out = std::move(item);
+		std::destroy_at(&item);
+		++head_;
+		return true;
+	}
+
+	// Перемещает до out.size() первых элементов в out и возвращает их число
+	size_t PopBatch(std::span<T> out) {
+		const size_t count = std::min(out.size(), Size());
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			ring_detail::CopyOut(data_.GetAddress(), Mask(), head_, out.data(), count);
+			head_ += count;
+		} else {
+			for (size_t i = 0; i < count; ++i) {
+				TryPop(out[i]);
+			}
+		}
+		return count;
+	}
+
+	void PopFront() noexcept {
+		assert(!Empty());
+		std::destroy_at(Slot(head_++));
+	}
+
+	void Clear() noexcept {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			while (!Empty()) {
+				PopFront();
+			}
+		}
+		head_ = tail_ = 0;
+	}
+
+	T& Front() noexcept {
+		assert(!Empty());
+		return *Slot(head_);
+	}
+	const T& Front() const noexcept {
+		assert(!Empty());
+		return *Slot(head_);
+	}
+
+	T& Back() noexcept {
+		assert(!Empty());
+		return *Slot(tail_ - 1);
+	}
+	const T& Back() const noexcept {
+		assert(!Empty());
+		return *Slot(tail_ - 1);
+	}
+
+	// Элемент index, считая от начала очереди
+	T& operator[](size_t index) noexcept {
+		assert(index < Size());
+		return *Slot(head_ + index);
+	}
+	const T& operator[](size_t index) const noexcept {
+		assert(index < Size());
+		return *Slot(head_ + index);
+	}
+
+	size_t Size() const noexcept {
+		return tail_ - head_;
+	}
+
+	size_t Capacity() const noexcept {
+		return capacity_;
+	}
+
+	bool Empty() const noexcept {
+		return head_ == tail_;
+	}
+
+	bool Full() const noexcept {
+		return Size() == Capacity();
+	}
+
+private:
+	size_t Mask() const noexcept {
+		return capacity_ - 1;
+	}
+
+	T* Slot(size_t position) noexcept {
+		return data_.GetAddress() + (position & Mask());
+	}
+	const T* Slot(size_t position) const noexcept {
+		return data_.GetAddress() + (position & Mask());
+	}
+
+	// Переносит элементы в новый буфер на new_capacity (степень двойки) элементов, начиная с позиции 0.
+	// Если элементы приходится копировать и копирование бросило исключение, очередь не меняется
+	void Relocate(size_t new_capacity) {
+		RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+		const size_t size = Size();
+		if (size != 0) {
+			T *from = data_.GetAddress();
+			const size_t offset = head_ & Mask();
+			const size_t first = std::min(size, Capacity() - offset);
+			T *to = new_data.GetAddress();
+			if constexpr (IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>
+					|| !std::is_copy_constructible_v<T>) {
+				UninitializedRelocate(from + offset, first, to);
+				UninitializedRelocate(from, size - first, to + first);
+			} else {
+				std::uninitialized_copy_n(from + offset, first, to);
+				try {
+					std::uninitialized_copy_n(from, size - first, to + first);
+				} catch (...) {
+					std::destroy_n(to, first);
+					throw;
+				}
+				std::destroy_n(from + offset, first);
+				std::destroy_n(from, size - first);
+			}
+		}
+		data_.Swap(new_data);
+		capacity_ = new_capacity;
+		head_ = 0;
+		tail_ = size;
+	}
+
+	RawMemory<T, Allocator> data_;
+	// Ёмкость RawMemory может оказаться больше запрошенной, а маске нужна степень двойки
+	size_t capacity_ = 0;
+	size_t head_ = 0;
+	size_t tail_ = 0;
+};
+
+// Очередь без блокировок для одного потока-производителя и одного потока-потребителя с фиксированной
+// ёмкостью. Индекс каждой стороны лежит в своей кэш-линии вместе с последним увиденным значением чужого
+// индекса; чужой индекс перечитывается, только когда по этому значению очередь кажется полной или пустой.
+// Push-методы вызываются только производителем, Pop-методы — только потребителем
+template<typename T, typename Allocator = std::allocator<T>>
+class SpscRingBuffer {
+	static constexpr size_t kCacheLineSize = 64;
+
+public:
+	explicit SpscRingBuffer(size_t capacity, const Allocator &alloc = Allocator()) :
+			data_(ring_detail::RoundUpCapacity(std::max<size_t>(capacity, 1)), alloc),
+			capacity_(ring_detail::RoundUpCapacity(std::max<size_t>(capacity, 1))) {
+	}
+
+	SpscRingBuffer(const SpscRingBuffer&) = delete;
+	SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+	~SpscRingBuffer() {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			const size_t tail = producer_.tail.load(std::memory_order_acquire);
+			for (size_t head = consumer_.head.load(std::memory_order_relaxed); head != tail; ++head) {
+				std::destroy_at(Slot(head));
+			}
+		}
+	}
+
+	template<typename ... Args>
+	bool TryEmplace(Args &&... args) {
+		const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+		if (FreeSlots(tail, 1) == 0) {
+			return false;
+		}
+		new (Slot(tail)) T(std::forward<Args>(args)...);
+		producer_.tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	template<typename M>
+	bool TryPush(M &&value) {
+		return TryEmplace(std::forward<M>(value));
+	}
+
+	// Копирует в очередь столько элементов items, сколько есть свободных мест, и возвращает их число
+	size_t PushBatch(std::span<const T> items) {
+		const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+		const size_t count = std::min(items.size(), FreeSlots(tail, items.size()));
+		if (count != 0) {
+			ring_detail::CopyIn(data_.GetAddress(), Mask(), tail, items.data(), count);
+			producer_.tail.store(tail + count, std::memory_order_release);
+		}
+		return count;
+	}
+
+	bool TryPop(T &out) {
+		const size_t head = consumer_.head.load(std::memory_order_relaxed);
+		if (ReadySlots(head, 1) == 0) {
+			return false;
+		}
+		T &item = *Slot(head);
+		out = std::move(item);
+		std::destroy_at(&item);
+		consumer_.head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Перемещает до out.size() готовых элементов в out и возвращает их число
+	size_t PopBatch(std::span<T> out) {
+		const size_t head = consumer_.head.load(std::memory_order_relaxed);
+		const size_t count = std::min(out.size(), ReadySlots(head, out.size()));
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			ring_detail::CopyOut(data_.GetAddress(), Mask(), head, out.data(), count);
+		} else {
+			size_t done = 0;
+			try {
+				for (; done < count; ++done) {
+					T &item = *Slot(head + done);
+					out[done] = std::move(item);
+					std::destroy_at(&item);
+				}
+			} catch (...) {
+				consumer_.head.store(head + done, std::memory_order_release);
+				throw;
+			}
+		}
+		consumer_.head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	// Приблизительный размер: индексы могут меняться во время вызова
+	size_t Size() const noexcept {
+		const size_t head = consumer_.head.load(std::memory_order_acquire);
+		return producer_.tail.load(std::memory_order_acquire) - head;
+	}
+
+	size_t Capacity() const noexcept {
+		return capacity_;
+	}
+
+private:
+	size_t Mask() const noexcept {
+		return capacity_ - 1;
+	}
+
+	T* Slot(size_t position) noexcept {
+		return data_.GetAddress() + (position & Mask());
+	}
+
+	// Свободные места для производителя. head перечитывается, только если по кэшу мест меньше wanted
+	size_t FreeSlots(size_t tail, size_t wanted) noexcept {
+		size_t free = capacity_ - (tail - producer_.cached_head);
+		if (free < wanted) {
+			producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+			free = capacity_ - (tail - producer_.cached_head);
+		}
+		return free;
+	}
+
+	// Готовые элементы для потребителя. tail перечитывается, только если по кэшу их меньше wanted
+	size_t ReadySlots(size_t head, size_t wanted) noexcept {
+		size_t ready = consumer_.cached_tail - head;
+		if (ready < wanted) {
+			consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+			ready = consumer_.cached_tail - head;
+		}
+		return ready;
+	}
+
+	struct alignas(kCacheLineSize) ConsumerSide {
+		std::atomic<size_t> head = 0;
+		size_t cached_tail = 0;
+	};
+
+	struct alignas(kCacheLineSize) ProducerSide {
+		std::atomic<size_t> tail = 0;
+		size_t cached_head = 0;
+	};
+
+	RawMemory<T, Allocator> data_;
+	size_t capacity_;
+	ConsumerSide consumer_;
+	ProducerSide producer_;
+};
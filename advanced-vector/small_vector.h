@@ -0,0 +1,293 @@
+#pragma once
+#include "vector.h"
+
+// Вектор, хранящий до N элементов прямо внутри объекта. Пока элементы помещаются во встроенный буфер,
+// динамическая память не выделяется; при переполнении элементы переносятся в RawMemory, как у Vector
+template<typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+	static_assert(N > 0, "SmallVector requires a non-zero inline capacity");
+	using AllocTraits = std::allocator_traits<Allocator>;
+public:
+	using iterator = T*;
+	using const_iterator = const T*;
+	using allocator_type = Allocator;
+
+	SmallVector() = default;
+
+	explicit SmallVector(const Allocator &alloc) noexcept :
+			heap_(alloc) {
+	}
+
+	explicit SmallVector(size_t size, const Allocator &alloc = Allocator()) :
+			heap_(alloc) {
+		Reserve(size);
+		std::uninitialized_value_construct_n(begin(), size);
+		size_ = size;
+	}
+
+	SmallVector(const SmallVector &other) :
+			heap_(AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+		Reserve(other.size_);
+		std::uninitialized_copy_n(other.begin(), other.size_, begin());
+		size_ = other.size_;
+	}
+
+	SmallVector& operator=(const SmallVector &other) {
+		if (this != &other) {
+			if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+				if (GetAllocator() != other.GetAllocator()) {
+					// Память, выделенную старым аллокатором, нужно вернуть ему же
+					Clear();
+					heap_ = RawMemory<T, Allocator>(other.GetAllocator());
+				} else {
+					heap_.GetAllocator() = other.GetAllocator();
+				}
+			}
+			AssignFrom(other.begin(), other.size_);
+		}
+		return *this;
+	}
+
+	SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+			heap_(other.GetAllocator()) {
+		if (other.IsInline()) {
+			UninitializedRelocate(other.begin(), other.size_, begin());
+		} else {
+			heap_.SwapBuffers(other.heap_);
+		}
+		size_ = std::exchange(other.size_, 0);
+	}
+
+	// Встроенные элементы other переносятся поэлементно без выделения памяти, поэтому бросить может
+	// только перенос между неравными аллокаторами
+	SmallVector& operator=(SmallVector &&other) noexcept((AllocTraits::propagate_on_container_move_assignment::value
+			|| AllocTraits::is_always_equal::value) && std::is_nothrow_move_constructible_v<T>
+			&& std::is_nothrow_move_assignable_v<T>) {
+		if (this != &other) {
+			if (other.IsInline()) {
+				if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+					if (GetAllocator() != other.GetAllocator()) {
+						// Память, выделенную старым аллокатором, нужно вернуть ему же
+						Clear();
+						heap_ = RawMemory<T, Allocator>(other.GetAllocator());
+					}
+				}
+				AssignFrom(std::make_move_iterator(other.begin()), other.size_);
+				other.Clear();
+			} else if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+				// Свой буфер освобождается своим аллокатором, вместе с буфером other забирается и его аллокатор
+				Clear();
+				heap_ = std::move(other.heap_);
+				size_ = std::exchange(other.size_, 0);
+			} else if (GetAllocator() == other.GetAllocator()) {
+				// Забираем буфер other, а свой старый буфер отдаём временному объекту на освобождение
+				Clear();
+				RawMemory<T, Allocator> old_heap(GetAllocator());
+				old_heap.SwapBuffers(heap_);
+				heap_.SwapBuffers(other.heap_);
+				size_ = std::exchange(other.size_, 0);
+			} else {
+				// Аллокаторы не равны и не распространяются: буфер other забрать нельзя
+				AssignFrom(std::make_move_iterator(other.begin()), other.size_);
+				other.Clear();
+			}
+		}
+		return *this;
+	}
+
+	void Reserve(size_t new_capacity) {
+		if (new_capacity <= Capacity()) {
+			return;
+		}
+		RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+		UninitializedRelocate(begin(), size_, new_data.GetAddress());
+		heap_.SwapBuffers(new_data);
+	}
+
+	// Динамические буферы обмениваются без переноса элементов, встроенные элементы переносятся во встроенный
+	// буфер другого вектора. Без propagate_on_container_swap аллокаторы должны быть равны
+	void Swap(SmallVector &other) noexcept(vector_detail::kNothrowRelocate<T> && std::is_nothrow_swappable_v<T>) {
+		if constexpr (!AllocTraits::propagate_on_container_swap::value) {
+			assert(GetAllocator() == other.GetAllocator());
+		}
+		if (IsInline() && other.IsInline()) {
+			SmallVector &shorter = size_ <= other.size_ ? *this : other;
+			SmallVector &longer = size_ <= other.size_ ? other : *this;
+			std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+			UninitializedRelocate(longer.begin() + shorter.size_, longer.size_ - shorter.size_, shorter.end());
+		} else if (IsInline() || other.IsInline()) {
+			SmallVector &inline_side = IsInline() ? *this : other;
+			SmallVector &heap_side = IsInline() ? other : *this;
+			UninitializedRelocate(inline_side.begin(), inline_side.size_, reinterpret_cast<T*>(heap_side.inline_));
+			inline_side.heap_.SwapBuffers(heap_side.heap_);
+		} else {
+			heap_.SwapBuffers(other.heap_);
+		}
+		if constexpr (AllocTraits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(heap_.GetAllocator(), other.heap_.GetAllocator());
+		}
+		std::swap(size_, other.size_);
+	}
+
+	void Resize(size_t new_size) {
+		if (new_size == size_) {
+			return;
+		} else if (new_size < size_) {
+			std::destroy_n(begin() + new_size, size_ - new_size);
+			size_ = new_size;
+		} else {
+			Reserve(new_size);
+			std::uninitialized_value_construct_n(begin() + size_, new_size - size_);
+			size_ = new_size;
+		}
+	}
+
+	template<typename M>
+	void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
+	}
+
+	template<typename ... Args>
+	T& EmplaceBack(Args &&... args) {
+		if (size_ == Capacity()) {
+			RawMemory<T, Allocator> new_data(NextCapacity(), GetAllocator());
+			new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
+			try {
+				UninitializedRelocate(begin(), size_, new_data.GetAddress());
+			} catch (...) {
+				std::destroy_at(new_data.GetAddress() + size_);
+				throw;
+			}
+			heap_.SwapBuffers(new_data);
+		} else {
+			new (begin() + size_) T(std::forward<Args>(args)...);
+		}
+		return begin()[size_++];
+	}
+
+	template<typename ... Args>
+	iterator Emplace(const_iterator pos, Args &&... args) {
+		size_t pos_index = pos - begin();
+		if (size_ == Capacity()) {
+			RawMemory<T, Allocator> new_data(NextCapacity(), GetAllocator());
+			new (new_data.GetAddress() + pos_index) T(std::forward<Args>(args)...);
+			try {
+				UninitializedRelocateAround(begin(), size_, pos_index, new_data.GetAddress());
+			} catch (...) {
+				std::destroy_at(new_data.GetAddress() + pos_index);
+				throw;
+			}
+			heap_.SwapBuffers(new_data);
+		} else if (pos_index == size_) {
+			new (end()) T(std::forward<Args>(args)...);
+		} else {
+			vector_detail::EmplaceInGap(begin(), size_, pos_index, std::forward<Args>(args)...);
+		}
+		++size_;
+		return begin() + pos_index;
+	}
+
+	iterator Insert(const_iterator pos, const T &item) {
+		return Emplace(pos, item);
+	}
+	iterator Insert(const_iterator pos, T &&item) {
+		return Emplace(pos, std::move(item));
+	}
+
+	iterator Erase(const_iterator pos) {
+		size_t pos_index = pos - begin();
+		vector_detail::EraseRange(begin(), size_, pos_index, 1);
+		--size_;
+		return begin() + pos_index;
+	}
+
+	void PopBack() noexcept {
+		std::destroy_at(end() - 1);
+		--size_;
+	}
+
+	size_t Size() const noexcept {
+		return size_;
+	}
+
+	size_t Capacity() const noexcept {
+		return IsInline() ? N : heap_.Capacity();
+	}
+
+	// Элементы находятся во встроенном буфере, а не в динамической памяти
+	bool IsInline() const noexcept {
+		return heap_.GetAddress() == nullptr;
+	}
+
+	const Allocator& GetAllocator() const noexcept {
+		return heap_.GetAllocator();
+	}
+
+	const T& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return begin()[index];
+	}
+
+	T& operator[](size_t index) noexcept {
+		assert(index < size_);
+		return begin()[index];
+	}
+
+	iterator begin() noexcept {
+		return IsInline() ? reinterpret_cast<T*>(inline_) : heap_.GetAddress();
+	}
+	iterator end() noexcept {
+		return begin() + size_;
+	}
+	const_iterator begin() const noexcept {
+		return const_cast<SmallVector&>(*this).begin();
+	}
+	const_iterator end() const noexcept {
+		return begin() + size_;
+	}
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	~SmallVector() {
+		std::destroy_n(begin(), size_);
+	}
+
+private:
+	size_t NextCapacity() const noexcept {
+		return GrowthPolicy::NextCapacity(Capacity(), size_ + 1, sizeof(T));
+	}
+
+	void Clear() noexcept {
+		std::destroy_n(begin(), size_);
+		size_ = 0;
+	}
+
+	// Присваивает элементы [first, first + count), по возможности переиспользуя уже выделенную память
+	template<typename RandomIt>
+	void AssignFrom(RandomIt first, size_t count) {
+		if (count <= Capacity()) {
+			if (size_ <= count) {
+				std::copy_n(first, size_, begin());
+				std::uninitialized_copy_n(first + size_, count - size_, begin() + size_);
+			} else {
+				std::copy_n(first, count, begin());
+				std::destroy_n(begin() + count, size_ - count);
+			}
+		} else {
+			RawMemory<T, Allocator> new_data(count, GetAllocator());
+			std::uninitialized_copy_n(first, count, new_data.GetAddress());
+			Clear();
+			heap_.SwapBuffers(new_data);
+		}
+		size_ = count;
+	}
+
+	alignas(T) unsigned char inline_[sizeof(T) * N];
+	RawMemory<T, Allocator> heap_;
+	size_t size_ = 0;
+};
@@ -0,0 +1,284 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор записей, хранящий каждое поле в отдельном непрерывном массиве (structure of arrays).
+// Все столбцы лежат в одном буфере RawMemory, начало каждого выровнено по кэш-линии, размер и ёмкость
+// общие, а рост подчиняется той же GrowthPolicy, что и у Vector. Просмотр одного поля превращается
+// в последовательное чтение одного массива
+template<typename GrowthPolicy, typename ... Ts>
+class BasicSoAVector {
+	static_assert(sizeof...(Ts) > 0, "SoAVector requires at least one field");
+
+	static constexpr size_t kColumnAlignment = 64;
+
+	// Единица выделения памяти, задающая выравнивание всего буфера
+	struct alignas(kColumnAlignment) Chunk {
+		unsigned char bytes[kColumnAlignment];
+	};
+
+	using Indices = std::index_sequence_for<Ts...>;
+
+public:
+	template<size_t I>
+	using FieldType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+	// Строка как набор ссылок на элементы всех столбцов
+	using Reference = std::tuple<Ts&...>;
+	using ConstReference = std::tuple<const Ts&...>;
+
+	BasicSoAVector() = default;
+
+	explicit BasicSoAVector(size_t size) {
+		Reserve(size);
+		ForEachColumn([size](auto *column, auto) {
+			std::uninitialized_value_construct_n(column, size);
+		}, Indices(), 0, size);
+		size_ = size;
+	}
+
+	BasicSoAVector(const BasicSoAVector &other) {
+		Reserve(other.size_);
+		CopyColumns(other);
+		size_ = other.size_;
+	}
+
+	BasicSoAVector& operator=(const BasicSoAVector &other) {
+		if (this != &other) {
+			BasicSoAVector copy(other);
+			Swap(copy);
+		}
+		return *this;
+	}
+
+	BasicSoAVector(BasicSoAVector &&other) noexcept {
+		Swap(other);
+	}
+
+	BasicSoAVector& operator=(BasicSoAVector &&other) noexcept {
+		if (this != &other) {
+			Clear();
+			Swap(other);
+		}
+		return *this;
+	}
+
+	~BasicSoAVector() {
+		Clear();
+	}
+
+	void Swap(BasicSoAVector &other) noexcept {
+		data_.Swap(other.data_);
+		std::swap(columns_, other.columns_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+	void Reserve(size_t new_capacity) {
+		if (new_capacity <= capacity_) {
+			return;
+		}
+		RawMemory<Chunk> new_data(BufferChunks(new_capacity));
+		std::tuple<Ts*...> new_columns = ColumnsOf(new_data, new_capacity, Indices());
+		RelocateColumns(new_columns, Indices());
+		Adopt(new_data, new_columns, new_capacity);
+	}
+
+	void Resize(size_t new_size) {
+		if (new_size < size_) {
+			DestroyRows(new_size, size_);
+			size_ = new_size;
+		} else if (new_size > size_) {
+			Reserve(new_size);
+			ForEachColumn([this, new_size](auto *column, auto) {
+				std::uninitialized_value_construct_n(column + size_, new_size - size_);
+			}, Indices(), size_, new_size);
+			size_ = new_size;
+		}
+	}
+
+	// Добавляет строку; каждый аргумент создаёт значение соответствующего столбца
+	template<typename ... Args>
+	Reference EmplaceBack(Args &&... args) {
+		static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack expects one value per field");
+		if (size_ == capacity_) {
+			const size_t new_capacity = GrowthPolicy::NextCapacity(capacity_, size_ + 1, (sizeof(Ts) + ...));
+			RawMemory<Chunk> new_data(BufferChunks(new_capacity));
+			std::tuple<Ts*...> new_columns = ColumnsOf(new_data, new_capacity, Indices());
+			// Новая строка создаётся до переноса, так как аргументы могут ссылаться на элементы вектора
+			ConstructRow(new_columns, size_, Indices(), std::forward<Args>(args)...);
+			try {
+				RelocateColumns(new_columns, Indices());
+			} catch (...) {
+				DestroyRow(new_columns, size_, Indices());
+				throw;
+			}
+			Adopt(new_data, new_columns, new_capacity);
+		} else {
+			ConstructRow(columns_, size_, Indices(), std::forward<Args>(args)...);
+		}
+		return (*this)[size_++];
+	}
+
+	template<typename ... Args>
+	void PushBack(Args &&... args) {
+		EmplaceBack(std::forward<Args>(args)...);
+	}
+
+	void PopBack() noexcept {
+		assert(size_ > 0);
+		DestroyRows(size_ - 1, size_);
+		--size_;
+	}
+
+	void Clear() noexcept {
+		DestroyRows(0, size_);
+		size_ = 0;
+	}
+
+	size_t Size() const noexcept {
+		return size_;
+	}
+
+	size_t Capacity() const noexcept {
+		return capacity_;
+	}
+
+	Reference operator[](size_t index) noexcept {
+		assert(index < size_);
+		return std::apply([index](auto *... columns) {
+			return Reference(columns[index]...);
+		}, columns_);
+	}
+
+	ConstReference operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return std::apply([index](auto *... columns) {
+			return ConstReference(columns[index]...);
+		}, columns_);
+	}
+
+	// Непрерывный массив значений поля I
+	template<size_t I>
+	std::span<FieldType<I>> Column() noexcept {
+		return std::span<FieldType<I>>(std::get<I>(columns_), size_);
+	}
+
+	template<size_t I>
+	std::span<const FieldType<I>> Column() const noexcept {
+		return std::span<const FieldType<I>>(std::get<I>(columns_), size_);
+	}
+
+private:
+	static constexpr size_t AlignUp(size_t bytes) noexcept {
+		return (bytes + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+	}
+
+	static size_t BufferChunks(size_t capacity) noexcept {
+		return (AlignUp(capacity * sizeof(Ts)) + ...) / kColumnAlignment;
+	}
+
+	// Адреса столбцов в буфере, рассчитанном на capacity строк
+	template<size_t ... I>
+	static std::tuple<Ts*...> ColumnsOf(RawMemory<Chunk> &data, size_t capacity, std::index_sequence<I...>) noexcept {
+		auto *base = reinterpret_cast<unsigned char*>(data.GetAddress());
+		size_t offsets[sizeof...(Ts)] = {};
+		size_t offset = 0;
+		((offsets[I] = offset, offset += AlignUp(capacity * sizeof(Ts))), ...);
+		return std::tuple<Ts*...>(reinterpret_cast<Ts*>(base + offsets[I])...);
+	}
+
+	void Adopt(RawMemory<Chunk> &new_data, const std::tuple<Ts*...> &new_columns, size_t new_capacity) noexcept {
+		data_.Swap(new_data);
+		columns_ = new_columns;
+		capacity_ = new_capacity;
+	}
+
+	// Вызывает init(столбец, индекс столбца) для каждого столбца. Если init бросил исключение, строки
+	// [first, last) уже заполненных столбцов разрушаются
+	template<typename Init, size_t ... I>
+	void ForEachColumn(Init init, std::index_sequence<I...>, size_t first, size_t last) {
+		size_t done = 0;
+		try {
+			((init(std::get<I>(columns_), std::integral_constant<size_t, I>()), ++done), ...);
+		} catch (...) {
+			((I < done ? std::destroy(std::get<I>(columns_) + first, std::get<I>(columns_) + last) : void()), ...);
+			throw;
+		}
+	}
+
+	void CopyColumns(const BasicSoAVector &other) {
+		ForEachColumn([&other](auto *column, auto index) {
+			std::uninitialized_copy_n(std::get<index()>(other.columns_), other.size_, column);
+		}, Indices(), 0, other.size_);
+	}
+
+	template<typename ... Args, size_t ... I>
+	static void ConstructRow(std::tuple<Ts*...> &columns, size_t row, std::index_sequence<I...>, Args &&... args) {
+		size_t done = 0;
+		try {
+			((new (std::get<I>(columns) + row) Ts(std::forward<Args>(args)), ++done), ...);
+		} catch (...) {
+			((I < done ? std::destroy_at(std::get<I>(columns) + row) : void()), ...);
+			throw;
+		}
+	}
+
+	template<size_t ... I>
+	static void DestroyRow(std::tuple<Ts*...> &columns, size_t row, std::index_sequence<I...>) noexcept {
+		(std::destroy_at(std::get<I>(columns) + row), ...);
+	}
+
+	void DestroyRows(size_t first, size_t last) noexcept {
+		std::apply([first, last](auto *... columns) {
+			(std::destroy(columns + first, columns + last), ...);
+		}, columns_);
+	}
+
+	// Столбец переносится без исключений
+	template<typename T>
+	static constexpr bool kNothrowRelocatable = IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>;
+
+	// Переносит все строки в новые столбцы. Если какой-то столбец приходится копировать и копирование
+	// бросило исключение, уже перенесённые элементы разрушаются, а исходные данные остаются нетронутыми
+	template<size_t ... I>
+	void RelocateColumns(std::tuple<Ts*...> &new_columns, std::index_sequence<I...>) {
+		if constexpr ((kNothrowRelocatable<Ts> && ...)) {
+			(UninitializedRelocate(std::get<I>(columns_), size_, std::get<I>(new_columns)), ...);
+		} else {
+			size_t done = 0;
+			try {
+				((TransferColumn(std::get<I>(columns_), size_, std::get<I>(new_columns)), ++done), ...);
+			} catch (...) {
+				((I < done ? void(std::destroy_n(std::get<I>(new_columns), size_)) : void()), ...);
+				throw;
+			}
+			DestroyRows(0, size_);
+		}
+	}
+
+	// Перемещает или копирует столбец, не разрушая исходных элементов
+	template<typename T>
+	static void TransferColumn(T *from, size_t count, T *to) {
+		if constexpr (kNothrowRelocatable<T> || !std::is_copy_constructible_v<T>) {
+			std::uninitialized_move_n(from, count, to);
+		} else {
+			std::uninitialized_copy_n(from, count, to);
+		}
+	}
+
+	RawMemory<Chunk> data_;
+	std::tuple<Ts*...> columns_ {};
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+
+template<typename ... Ts>
+using SoAVector = BasicSoAVector<DoublingGrowth, Ts...>;
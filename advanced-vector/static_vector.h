@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace static_vector_detail {
+
+// Элементы тривиальных типов хранятся в обычном массиве, созданном целиком: только такой массив можно
+// создать в константном вычислении и сохранить в constexpr-переменной
+template<typename T>
+inline constexpr bool kLiteralStorage = std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>;
+
+template<typename T, size_t N, bool = kLiteralStorage<T>>
+struct Storage {
+	constexpr T* Data() noexcept {
+		return items;
+	}
+	constexpr const T* Data() const noexcept {
+		return items;
+	}
+
+	T items[N != 0 ? N : 1] = {};
+};
+
+// Для остальных типов — сырая память, в которой элементы создаются по мере добавления
+template<typename T, size_t N>
+struct Storage<T, N, false> {
+	T* Data() noexcept {
+		return std::launder(reinterpret_cast<T*>(bytes));
+	}
+	const T* Data() const noexcept {
+		return std::launder(reinterpret_cast<const T*>(bytes));
+	}
+
+	alignas(T) unsigned char bytes[sizeof(T) * (N != 0 ? N : 1)];
+};
+
+}  // namespace static_vector_detail
+
+// Вектор с ёмкостью N, хранящий элементы внутри себя, без обращений к куче. Интерфейс повторяет Vector;
+// при попытке превысить ёмкость бросается std::length_error. Для тривиальных T все операции constexpr,
+// а сам вектор тривиально копируем, поэтому таблицы можно строить при компиляции:
+//     constexpr auto kTable = [] {
+//         StaticVector<int, 64> table;
+//         ... table.PushBack(...) ...
+//         return table;
+//     }();
+// Vector тоже constexpr, но память, выделенная при компиляции, не может дожить до выполнения программы,
+// поэтому результат переносится в StaticVector конструктором из диапазона
+template<typename T, size_t N>
+class StaticVector {
+	static constexpr bool kTrivial = static_vector_detail::kLiteralStorage<T> && std::is_trivially_copyable_v<T>;
+
+public:
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	constexpr StaticVector() noexcept = default;
+
+	constexpr explicit StaticVector(size_t size) {
+		CheckCapacity(size);
+		UninitializedValueConstructN(data(), size);
+		size_ = size;
+	}
+
+	constexpr StaticVector(std::initializer_list<T> items) :
+			StaticVector(items.begin(), items.end()) {
+	}
+
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	constexpr StaticVector(InputIt first, InputIt last) {
+		for (; first != last; ++first) {
+			EmplaceBack(*first);
+		}
+	}
+
+	constexpr StaticVector(const StaticVector&) requires kTrivial = default;
+	constexpr StaticVector(const StaticVector &other) {
+		UninitializedCopyN(other.data(), other.size_, data());
+		size_ = other.size_;
+	}
+
+	constexpr StaticVector(StaticVector&&) requires kTrivial = default;
+	constexpr StaticVector(StaticVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+		UninitializedMoveN(other.data(), other.size_, data());
+		size_ = other.size_;
+	}
+
+	constexpr StaticVector& operator=(const StaticVector&) requires kTrivial = default;
+	constexpr StaticVector& operator=(const StaticVector &other) {
+		if (this != &other) {
+			Assign(other.data(), other.size_);
+		}
+		return *this;
+	}
+
+	constexpr StaticVector& operator=(StaticVector&&) requires kTrivial = default;
+	constexpr StaticVector& operator=(StaticVector &&other) noexcept(std::is_nothrow_move_assignable_v<T>
+			&& std::is_nothrow_move_constructible_v<T>) {
+		if (this != &other) {
+			Assign(std::make_move_iterator(other.data()), other.size_);
+		}
+		return *this;
+	}
+
+	constexpr ~StaticVector() requires std::is_trivially_destructible_v<T> = default;
+	constexpr ~StaticVector() {
+		std::destroy_n(data(), size_);
+	}
+
+	template<typename M>
+	constexpr void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
+	}
+
+	template<typename ... Args>
+	constexpr T& EmplaceBack(Args &&... args) {
+		CheckCapacity(size_ + 1);
+		T *item = std::construct_at(data() + size_, std::forward<Args>(args)...);
+		++size_;
+		return *item;
+	}
+
+	template<typename ... Args>
+	constexpr iterator Emplace(const_iterator pos, Args &&... args) {
+		const size_t pos_index = pos - begin();
+		CheckCapacity(size_ + 1);
+		if (pos_index == size_) {
+			std::construct_at(end(), std::forward<Args>(args)...);
+		} else {
+			vector_detail::EmplaceInGap(data(), size_, pos_index, std::forward<Args>(args)...);
+		}
+		++size_;
+		return begin() + pos_index;
+	}
+
+	constexpr iterator Insert(const_iterator pos, const T &item) {
+		return Emplace(pos, item);
+	}
+	constexpr iterator Insert(const_iterator pos, T &&item) {
+		return Emplace(pos, std::move(item));
+	}
+
+	constexpr iterator Erase(const_iterator pos) {
+		return Erase(pos, pos + 1);
+	}
+
+	constexpr iterator Erase(const_iterator first, const_iterator last) {
+		const size_t first_index = first - begin();
+		const size_t count = last - first;
+		vector_detail::EraseRange(data(), size_, first_index, count);
+		size_ -= count;
+		return begin() + first_index;
+	}
+
+	constexpr void PopBack() noexcept {
+		assert(size_ != 0);
+		std::destroy_at(end() - 1);
+		--size_;
+	}
+
+	constexpr void Resize(size_t new_size) {
+		if (new_size < size_) {
+			DestroyTail(new_size);
+		} else if (new_size > size_) {
+			CheckCapacity(new_size);
+			UninitializedValueConstructN(end(), new_size - size_);
+			size_ = new_size;
+		}
+	}
+
+	constexpr void Clear() noexcept {
+		DestroyTail(0);
+	}
+
+	constexpr size_t Size() const noexcept {
+		return size_;
+	}
+
+	static constexpr size_t Capacity() noexcept {
+		return N;
+	}
+
+	constexpr const T& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return data()[index];
+	}
+
+	constexpr T& operator[](size_t index) noexcept {
+		assert(index < size_);
+		return data()[index];
+	}
+
+	constexpr iterator begin() noexcept {
+		return data();
+	}
+	constexpr iterator end() noexcept {
+		return data() + size_;
+	}
+	constexpr const_iterator begin() const noexcept {
+		return data();
+	}
+	constexpr const_iterator end() const noexcept {
+		return data() + size_;
+	}
+	constexpr const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	constexpr const_iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	constexpr T* data() noexcept {
+		return storage_.Data();
+	}
+	constexpr const T* data() const noexcept {
+		return storage_.Data();
+	}
+
+	static constexpr void CheckCapacity(size_t required) {
+		if (required > N) {
+			throw std::length_error("StaticVector capacity exceeded");
+		}
+	}
+
+	constexpr void DestroyTail(size_t new_size) noexcept {
+		std::destroy(data() + new_size, end());
+		size_ = new_size;
+	}
+
+	template<typename InputIt>
+	constexpr void Assign(InputIt first, size_t count) {
+		if (size_ <= count) {
+			std::copy_n(first, size_, data());
+			UninitializedCopyN(std::next(first, size_), count - size_, end());
+			size_ = count;
+		} else {
+			std::copy_n(first, count, data());
+			DestroyTail(count);
+		}
+	}
+
+	static_vector_detail::Storage<T, N> storage_;
+	size_t size_ = 0;
+};
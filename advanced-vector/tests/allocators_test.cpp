@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "allocators.h"
+#include "arena.h"
+#include "pool_allocator.h"
+#include "vector.h"
+
+namespace {
+
+TEST(AlignedAllocatorTest, BufferStaysAligned) {
+	AlignedVector<float, 64> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.PushBack(float(i));
+		ASSERT_EQ(reinterpret_cast<uintptr_t>(v.Data()) % 64, 0u);
+	}
+	Vector<char, AlignedAllocator<char, 4096>> page(10);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(page.Data()) % 4096, 0u);
+}
+
+TEST(AlignedAllocatorTest, HugeBuffersAreHugePageAligned) {
+	Vector<char, AlignedAllocator<char, 64, 1 << 20>> v(size_t(3) << 20);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(v.Data()) % (size_t(2) << 20), 0u);
+	v[v.Size() - 1] = 1;
+	v.ShrinkToFit();
+	EXPECT_EQ(v[v.Size() - 1], 1);
+}
+
+TEST(ArenaTest, LastAllocationGrowsInPlace) {
+	MonotonicArena arena(1 << 16);
+	ArenaVector<int> v {ArenaAllocator<int>(arena)};
+	v.Reserve(16);
+	const int *data = v.Data();
+	for (int i = 0; i < 1000; ++i) {
+		v.PushBack(i);
+	}
+	// Вектор — единственный пользователь арены, поэтому буфер каждый раз удлиняется на месте
+	EXPECT_EQ(v.Data(), data);
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_EQ(v[i], i);
+	}
+}
+
+TEST(ArenaTest, VectorsShareArena) {
+	MonotonicArena arena(256);
+	ArenaVector<int> a {ArenaAllocator<int>(arena)};
+	ArenaVector<int> b {ArenaAllocator<int>(arena)};
+	for (int i = 0; i < 500; ++i) {
+		a.PushBack(i);
+		b.PushBack(-i);
+	}
+	EXPECT_EQ(a[499], 499);
+	EXPECT_EQ(b[499], -499);
+	EXPECT_GE(arena.ReservedBytes(), 2 * 500 * sizeof(int));
+	EXPECT_TRUE(a.GetAllocator() == b.GetAllocator());
+	a.Swap(b);
+	EXPECT_EQ(a[1], -1);
+}
+
+TEST(PoolAllocatorTest, CapacityUsesWholeBlock) {
+	PooledVector<int> v;
+	v.PushBack(1);
+	EXPECT_EQ(v.Capacity() * sizeof(int), ThreadCachingPool::UsableSize(sizeof(int)));
+	for (int i = 0; i < 100000; ++i) {
+		v.PushBack(i);
+	}
+	EXPECT_EQ(v[100000], 99999);
+}
+
+TEST(PoolAllocatorTest, BlocksMoveBetweenThreads) {
+	std::vector<PooledVector<int>> vectors(64);
+	std::thread producer([&vectors] {
+		for (size_t i = 0; i < vectors.size(); ++i) {
+			vectors[i].Reserve(i + 1);
+			vectors[i].PushBack(int(i));
+		}
+	});
+	producer.join();
+	// Блоки, выделенные в завершившемся потоке, освобождаются в этом
+	for (size_t i = 0; i < vectors.size(); ++i) {
+		EXPECT_EQ(vectors[i][0], int(i));
+	}
+	vectors.clear();
+}
+
+TEST(PoolAllocatorTest, ThreadLocalVectorOutlivesThreadCache) {
+	std::thread worker([] {
+		// Вектор создаётся раньше кэша пула, поэтому разрушается после него
+		thread_local PooledVector<int> survivor;
+		for (int i = 0; i < 100; ++i) {
+			survivor.PushBack(i);
+		}
+	});
+	worker.join();
+	PooledVector<int> v(100);
+	EXPECT_EQ(v.Size(), 100u);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bit_vector.h"
+#include "test_helpers.h"
+
+namespace {
+
+TEST(BitVectorTest, MatchesVectorOfBool) {
+	BitVector<> bits;
+	std::vector<bool> model;
+	for (size_t i = 0; i < 1000; ++i) {
+		const bool value = i % 3 == 0 || i % 7 == 0;
+		bits.PushBack(value);
+		model.push_back(value);
+	}
+	bits.Flip(10);
+	model[10] = !model[10];
+	bits[11] = true;
+	model[11] = true;
+	ASSERT_EQ(bits.Size(), model.size());
+	size_t count = 0;
+	for (size_t i = 0; i < model.size(); ++i) {
+		ASSERT_EQ(bits[i], model[i]) << i;
+		count += model[i];
+	}
+	EXPECT_EQ(bits.Count(), count);
+	EXPECT_EQ(bits.Words().size(), (model.size() + 63) / 64);
+}
+
+TEST(BitVectorTest, FindIteratesSetBits) {
+	BitVector<> bits(500);
+	const std::vector<size_t> positions {3, 64, 65, 200, 499};
+	for (size_t pos : positions) {
+		bits.Set(pos);
+	}
+	std::vector<size_t> found;
+	for (size_t pos = bits.FindFirst(); pos != bits.Size(); pos = bits.FindNext(pos)) {
+		found.push_back(pos);
+	}
+	EXPECT_EQ(found, positions);
+	EXPECT_EQ(BitVector<>(100).FindFirst(), 100u);
+}
+
+TEST(BitVectorTest, BitwiseOperationsAndTail) {
+	BitVector<> a(130, true);
+	BitVector<> b(130);
+	for (size_t i = 0; i < 130; i += 2) {
+		b.Set(i);
+	}
+	BitVector<> both = a;
+	both &= b;
+	EXPECT_EQ(both.Count(), 65u);
+	BitVector<> diff = a;
+	diff.AndNot(b);
+	EXPECT_EQ(diff.Count(), 65u);
+	diff ^= a;
+	EXPECT_EQ(diff, both);
+	diff |= a;
+	EXPECT_EQ(diff, a);
+
+	// Биты за Size() в последнем слове всегда нулевые
+	a.Resize(70);
+	EXPECT_EQ(a.Count(), 70u);
+	EXPECT_EQ(a.Words()[1], (uint64_t(1) << 6) - 1);
+	a.Resize(100, false);
+	EXPECT_EQ(a.Count(), 70u);
+	a.Fill(true);
+	EXPECT_EQ(a.Count(), 100u);
+}
+
+TEST(BitVectorTest, MoveAssignmentRespectsAllocator) {
+	using Alloc = TaggedAllocator<uint64_t>;
+	{
+		BitVector<Alloc> source(200, true, Alloc(1));
+		BitVector<Alloc> target(10, false, Alloc(2));
+		target = std::move(source);
+		// Аллокаторы не равны и не распространяются: target копирует биты в свой буфер
+		EXPECT_EQ(target.GetAllocator().Id(), 2);
+		EXPECT_EQ(target.Size(), 200u);
+		EXPECT_EQ(target.Count(), 200u);
+	}
+	using PropagatingAlloc = TaggedAllocator<uint64_t, true>;
+	{
+		BitVector<PropagatingAlloc> source(200, true, PropagatingAlloc(1));
+		BitVector<PropagatingAlloc> target(PropagatingAlloc(2));
+		target = std::move(source);
+		EXPECT_EQ(target.GetAllocator().Id(), 1);
+		EXPECT_EQ(target.Count(), 200u);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+	EXPECT_EQ(PropagatingAlloc::LiveBlocks(), 0u);
+}
+
+TEST(BitVectorTest, CopyAssignmentAndSwapRespectAllocator) {
+	using Alloc = TaggedAllocator<uint64_t>;
+	{
+		BitVector<Alloc> source(300, true, Alloc(1));
+		BitVector<Alloc> target(10, false, Alloc(2));
+		target = source;
+		// Аллокатор не распространяется: новый буфер выделяет аллокатор target
+		EXPECT_EQ(target.GetAllocator().Id(), 2);
+		EXPECT_EQ(target.Count(), 300u);
+		BitVector<Alloc> other(5, true, Alloc(2));
+		target.Swap(other);
+		EXPECT_EQ(target.Size(), 5u);
+		EXPECT_EQ(other.Count(), 300u);
+	}
+	using PropagatingAlloc = TaggedAllocator<uint64_t, true>;
+	{
+		BitVector<PropagatingAlloc> source(300, true, PropagatingAlloc(1));
+		BitVector<PropagatingAlloc> target(10, false, PropagatingAlloc(2));
+		target = source;
+		EXPECT_EQ(target.GetAllocator().Id(), 1);
+		EXPECT_EQ(target.Count(), 300u);
+		BitVector<PropagatingAlloc> other(5, true, PropagatingAlloc(3));
+		target.Swap(other);
+		EXPECT_EQ(target.GetAllocator().Id(), 3);
+		EXPECT_EQ(other.GetAllocator().Id(), 1);
+		EXPECT_EQ(target.Count(), 5u);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+	EXPECT_EQ(PropagatingAlloc::LiveBlocks(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrent_vector.h"
+
+namespace {
+
+// Сколько ещё выделений разрешено LimitedAllocator; отрицательное значение снимает ограничение
+int allocations_left = -1;
+
+// Аллокатор, который отказывает после allocations_left успешных выделений
+template<typename T>
+struct LimitedAllocator {
+	using value_type = T;
+
+	LimitedAllocator() = default;
+
+	template<typename U>
+	LimitedAllocator(const LimitedAllocator<U>&) noexcept {
+	}
+
+	T* allocate(size_t n) {
+		if (allocations_left == 0) {
+			throw std::bad_alloc();
+		}
+		if (allocations_left > 0) {
+			--allocations_left;
+		}
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T *p, size_t n) noexcept {
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template<typename U>
+	bool operator==(const LimitedAllocator<U>&) const noexcept {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const LimitedAllocator<U>&) const noexcept {
+		return false;
+	}
+};
+
+TEST(ConcurrentVectorTest, ParallelPushBackKeepsEveryElement) {
+	constexpr int kThreads = 4;
+	constexpr int kPerThread = 20000;
+	ConcurrentVector<int> v;
+	std::vector<std::thread> writers;
+	for (int t = 0; t < kThreads; ++t) {
+		writers.emplace_back([&v, t] {
+			for (int i = 0; i < kPerThread; ++i) {
+				v.PushBack(t * kPerThread + i);
+			}
+		});
+	}
+	// Читатель видит только опубликованные элементы
+	std::thread reader([&v] {
+		while (v.Size() < size_t(kThreads * kPerThread)) {
+			const size_t size = v.Size();
+			if (size != 0) {
+				const int value = v[size - 1];
+				ASSERT_GE(value, 0);
+				ASSERT_LT(value, kThreads * kPerThread);
+			}
+		}
+	});
+	for (std::thread &writer : writers) {
+		writer.join();
+	}
+	reader.join();
+	ASSERT_EQ(v.Size(), size_t(kThreads * kPerThread));
+	std::vector<int> values(v.begin(), v.end());
+	std::sort(values.begin(), values.end());
+	for (int i = 0; i < kThreads * kPerThread; ++i) {
+		ASSERT_EQ(values[i], i);
+	}
+}
+
+TEST(ConcurrentVectorTest, AddressesAreStable) {
+	ConcurrentVector<std::unique_ptr<int>> v;
+	std::vector<const std::unique_ptr<int>*> addresses;
+	for (int i = 0; i < 1000; ++i) {
+		addresses.push_back(&v.EmplaceBack(std::make_unique<int>(i)));
+	}
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_EQ(&v[i], addresses[i]);
+		EXPECT_EQ(*v[i], i);
+	}
+	EXPECT_GE(v.Capacity(), 1000u);
+}
+
+TEST(ConcurrentVectorTest, FailedSegmentAllocationClaimsNoSlot) {
+	ConcurrentVector<int, LimitedAllocator<int>> v;
+	allocations_left = 1;
+	for (int i = 0; i < 16; ++i) {
+		v.PushBack(i);
+	}
+	// Первый сегмент заполнен, второй выделить не удаётся
+	EXPECT_THROW(v.PushBack(16), std::bad_alloc);
+	EXPECT_THROW(v.PushBack(16), std::bad_alloc);
+	EXPECT_EQ(v.Size(), 16u);
+	allocations_left = -1;
+	v.PushBack(16);
+	ASSERT_EQ(v.Size(), 17u);
+	EXPECT_EQ(v[16], 16);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "devector.h"
+#include "small_vector.h"
+#include "static_vector.h"
+#include "test_helpers.h"
+#include "thin_vector.h"
+#include "vector.h"
+
+// Общие для всех последовательных контейнеров проверки вставки: аргумент Emplace может ссылаться
+// на элемент самого контейнера, а исключение из конструктора элемента не должно менять содержимое
+
+namespace {
+
+struct VectorKind {
+	template<typename T>
+	using Container = Vector<T>;
+};
+
+struct SmallVectorKind {
+	template<typename T>
+	using Container = SmallVector<T, 4>;
+};
+
+struct ThinVectorKind {
+	template<typename T>
+	using Container = ThinVector<T>;
+};
+
+struct StaticVectorKind {
+	template<typename T>
+	using Container = StaticVector<T, 256>;
+};
+
+struct DevectorKind {
+	template<typename T>
+	using Container = Devector<T>;
+};
+
+template<typename Kind>
+class ContainerTest : public ::testing::Test {
+protected:
+	template<typename T>
+	using Container = typename Kind::template Container<T>;
+
+	void SetUp() override {
+		Tracked::Reset();
+	}
+
+	void TearDown() override {
+		EXPECT_EQ(Tracked::alive, 0);
+	}
+};
+
+using Kinds = ::testing::Types<VectorKind, SmallVectorKind, ThinVectorKind, StaticVectorKind, DevectorKind>;
+TYPED_TEST_SUITE(ContainerTest, Kinds);
+
+std::string Item(int i) {
+	// Длинная строка не помещается в SSO, поэтому висячая ссылка на сдвинутый элемент заметна
+	return std::string(32, char('a' + i % 26)) + std::to_string(i);
+}
+
+TYPED_TEST(ContainerTest, InsertCopiesOfOwnElements) {
+	typename TestFixture::template Container<std::string> c;
+	std::vector<std::string> model;
+	c.PushBack(Item(0));
+	model.push_back(Item(0));
+	for (size_t step = 1; step < 150; ++step) {
+		const size_t pos = step * 7 % (model.size() + 1);
+		const size_t source = step * 5 % model.size();
+		if (step % 2 == 0) {
+			c.Emplace(c.begin() + pos, c[source]);
+		} else {
+			c.Insert(c.begin() + pos, c[source]);
+		}
+		model.insert(model.begin() + pos, model[source]);
+		if (step % 3 == 0) {
+			const size_t erased = step * 3 % model.size();
+			c.Erase(c.begin() + erased);
+			model.erase(model.begin() + erased);
+		}
+		if (step % 10 == 0) {
+			c.PushBack(Item(int(step)));
+			model.push_back(Item(int(step)));
+		}
+		ASSERT_EQ(std::vector<std::string>(c.begin(), c.end()), model) << "step " << step;
+	}
+}
+
+TYPED_TEST(ContainerTest, MoveOwnElementIntoInsertedSlot) {
+	typename TestFixture::template Container<std::string> c;
+	for (int i = 0; i < 6; ++i) {
+		c.PushBack(Item(i));
+	}
+	c.Emplace(c.begin() + 1, std::move(c[4]));
+	ASSERT_EQ(c.Size(), 7u);
+	EXPECT_EQ(c[1], Item(4));
+	EXPECT_EQ(c[0], Item(0));
+	EXPECT_EQ(c[2], Item(1));
+	EXPECT_EQ(c[6], Item(5));
+}
+
+TYPED_TEST(ContainerTest, InsertKeepsContentsWhenCopyThrows) {
+	typename TestFixture::template Container<Tracked> c;
+	std::vector<int> expected;
+	const Tracked outside(100);
+	// Проверки на каждом размере попадают и на вставку в свободную ёмкость, и на вставку с ростом
+	for (int i = 0; i < 10; ++i) {
+		for (size_t pos = 0; pos <= c.Size(); ++pos) {
+			Tracked::copies_until_throw = 0;
+			EXPECT_THROW(c.Emplace(c.begin() + pos, outside), std::runtime_error);
+			EXPECT_THROW(c.Insert(c.begin() + pos, outside), std::runtime_error);
+			if (c.Size() != 0) {
+				EXPECT_THROW(c.Emplace(c.begin() + pos, c[c.Size() - 1]), std::runtime_error);
+			}
+			Tracked::copies_until_throw = -1;
+			ASSERT_EQ(ValuesOf(c), expected) << "size " << c.Size() << ", position " << pos;
+			ASSERT_EQ(Tracked::alive, int(c.Size()) + 1);
+		}
+		c.EmplaceBack(i);
+		expected.push_back(i);
+	}
+}
+
+}  // namespace
@@ -0,0 +1,188 @@
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "devector.h"
+#include "test_helpers.h"
+
+namespace {
+
+TEST(DevectorTest, PushFrontAndBackMatchDeque) {
+	Devector<int> d;
+	std::deque<int> model;
+	for (int i = 0; i < 1000; ++i) {
+		if (i % 3 == 0) {
+			d.PushBack(i);
+			model.push_back(i);
+		} else {
+			d.PushFront(i);
+			model.push_front(i);
+		}
+		if (i % 7 == 0) {
+			d.PopFront();
+			model.pop_front();
+		}
+	}
+	ASSERT_EQ(std::vector<int>(d.begin(), d.end()), std::vector<int>(model.begin(), model.end()));
+	EXPECT_EQ(d.Front(), model.front());
+	EXPECT_EQ(d.Back(), model.back());
+}
+
+TEST(DevectorTest, FrontInsertionIsAmortizedConstant) {
+	Tracked::Reset();
+	{
+		Devector<Tracked> d;
+		for (int i = 0; i < 1024; ++i) {
+			d.EmplaceFront(i);
+		}
+		// При сдвиге в конец вставка в начало стоила бы O(n) перемещений на элемент
+		EXPECT_LT(Tracked::moves, 4 * 1024);
+		EXPECT_EQ(d.Front().value, 1023);
+		EXPECT_EQ(d.Back().value, 0);
+	}
+	EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(DevectorTest, EmplaceInTheMiddleConstructsInPlace) {
+	Tracked::Reset();
+	{
+		Devector<Tracked> d;
+		d.ReserveFront(8);
+		d.ReserveBack(8);
+		for (int i = 0; i < 6; ++i) {
+			d.EmplaceBack(i);
+		}
+		Tracked::moves = 0;
+		// Сдвигается только меньшая часть массива, а новый элемент создаётся сразу на своём месте
+		d.Emplace(d.begin() + 2, 42);
+		EXPECT_EQ(Tracked::moves, 2);
+		d.Emplace(d.begin() + 5, 43);
+		EXPECT_EQ(Tracked::moves, 4);
+		EXPECT_EQ(Tracked::copies, 0);
+		EXPECT_EQ(ValuesOf(d), (std::vector<int> {0, 1, 42, 2, 3, 43, 4, 5}));
+	}
+	EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(DevectorTest, EmplaceWithThrowingMove) {
+	TrackedThrowingMove::Reset();
+	{
+		Devector<TrackedThrowingMove> d;
+		d.ReserveFront(4);
+		d.ReserveBack(4);
+		for (int i = 0; i < 6; ++i) {
+			d.EmplaceBack(i);
+		}
+		d.Emplace(d.begin() + 1, 10);
+		d.Emplace(d.begin() + 5, 11);
+		const TrackedThrowingMove item(12);
+		d.Emplace(d.begin() + 2, item);
+		d.Emplace(d.begin() + 1, d[6]);
+		EXPECT_EQ(ValuesOf(d), (std::vector<int> {0, 11, 10, 12, 1, 2, 3, 11, 4, 5}));
+	}
+	EXPECT_EQ(TrackedThrowingMove::alive, 0);
+}
+
+TEST(DevectorTest, ReserveBothSides) {
+	Devector<std::string> d {"b", "c"};
+	d.ReserveFront(10);
+	d.ReserveBack(20);
+	EXPECT_GE(d.FrontSpare(), 10u);
+	EXPECT_GE(d.BackSpare(), 20u);
+	const std::string *data = &d[0];
+	for (int i = 0; i < 10; ++i) {
+		d.PushFront("a");
+	}
+	EXPECT_EQ(&d[10], data);
+	d.Clear();
+	EXPECT_EQ(d.Size(), 0u);
+	EXPECT_EQ(d.FrontSpare(), d.Capacity() / 2);
+}
+
+TEST(DevectorTest, CopyAndMove) {
+	Devector<std::string> d {"x", "y"};
+	d.PushFront("w");
+	Devector<std::string> copy(d);
+	Devector<std::string> moved(std::move(d));
+	EXPECT_EQ(std::vector<std::string>(copy.begin(), copy.end()), (std::vector<std::string> {"w", "x", "y"}));
+	EXPECT_EQ(std::vector<std::string>(moved.begin(), moved.end()), (std::vector<std::string> {"w", "x", "y"}));
+	copy = moved;
+	moved.Erase(moved.begin() + 1);
+	EXPECT_EQ(moved.Size(), 2u);
+	EXPECT_EQ(copy.Size(), 3u);
+}
+
+TEST(DevectorTest, CopyAssignmentReusesBuffer) {
+	using Alloc = TaggedAllocator<std::string>;
+	{
+		Devector<std::string, Alloc> source({"a", "b", "c"}, Alloc(1));
+		Devector<std::string, Alloc> target(Alloc(2));
+		target.ReserveBack(8);
+		target.PushBack("x");
+		const std::string *data = &target[0];
+		target = source;
+		EXPECT_EQ(target.GetAllocator().Id(), 2);
+		EXPECT_EQ(&target[0], data);
+		EXPECT_EQ(std::vector<std::string>(target.begin(), target.end()), (std::vector<std::string> {"a", "b", "c"}));
+		source.PushFront("z");
+		target = source;
+		EXPECT_EQ(target.Size(), 4u);
+		EXPECT_EQ(target.Front(), "z");
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+TEST(DevectorTest, MoveAssignmentWithUnequalAllocatorsMovesElements) {
+	using Alloc = TaggedAllocator<Tracked>;
+	Tracked::Reset();
+	{
+		Devector<Tracked, Alloc> source(Alloc(1));
+		Devector<Tracked, Alloc> target(Alloc(2));
+		for (int i = 0; i < 5; ++i) {
+			source.EmplaceFront(i);
+		}
+		target.EmplaceBack(100);
+		target = std::move(source);
+		EXPECT_EQ(target.GetAllocator().Id(), 2);
+		EXPECT_EQ(ValuesOf(target), (std::vector<int> {4, 3, 2, 1, 0}));
+		EXPECT_EQ(Tracked::copies, 0);
+	}
+	EXPECT_EQ(Tracked::alive, 0);
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+TEST(DevectorTest, MoveAssignmentWithPropagatingAllocatorStealsBuffer) {
+	using Alloc = TaggedAllocator<int, true>;
+	{
+		Devector<int, Alloc> source(Alloc(1));
+		Devector<int, Alloc> target(Alloc(2));
+		source.PushFront(5);
+		target.PushBack(6);
+		const int *data = &source[0];
+		target = std::move(source);
+		EXPECT_EQ(target.GetAllocator().Id(), 1);
+		EXPECT_EQ(&target[0], data);
+		EXPECT_EQ(source.Size(), 0u);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+TEST(DevectorTest, CopyAndSwapPropagateAllocator) {
+	using Alloc = TaggedAllocator<int, true>;
+	{
+		Devector<int, Alloc> a({1}, Alloc(1));
+		Devector<int, Alloc> b({2, 3}, Alloc(2));
+		a.Swap(b);
+		EXPECT_EQ(a.GetAllocator().Id(), 2);
+		EXPECT_EQ(b.GetAllocator().Id(), 1);
+		EXPECT_EQ(a.Size(), 2u);
+		b = a;
+		EXPECT_EQ(b.GetAllocator().Id(), 2);
+		EXPECT_EQ(b[1], 3);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,99 @@
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flat_map.h"
+#include "test_helpers.h"
+
+namespace {
+
+TEST(FlatSetTest, KeepsKeysSortedAndUnique) {
+	FlatSet<int> set {5, 1, 3, 1, 5};
+	EXPECT_EQ(std::vector<int>(set.begin(), set.end()), (std::vector<int> {1, 3, 5}));
+	EXPECT_TRUE(set.Insert(2).second);
+	EXPECT_FALSE(set.Insert(3).second);
+	const std::vector<int> batch {9, 0, 4, 4, 2};
+	set.Insert(batch.begin(), batch.end());
+	EXPECT_EQ(std::vector<int>(set.begin(), set.end()), (std::vector<int> {0, 1, 2, 3, 4, 5, 9}));
+	EXPECT_TRUE(set.Contains(9));
+	EXPECT_EQ(*set.LowerBound(6), 9);
+	EXPECT_EQ(set.Erase(4), 1u);
+	EXPECT_EQ(set.Erase(4), 0u);
+	EXPECT_EQ(set.EraseIf([](int key) {
+		return key % 2 == 0;
+	}), 2u);
+	EXPECT_EQ(std::vector<int>(set.begin(), set.end()), (std::vector<int> {1, 3, 5, 9}));
+	EXPECT_EQ(set.Find(7), set.end());
+}
+
+TEST(FlatSetTest, CustomComparator) {
+	FlatSet<std::string, std::greater<std::string>> set {"a", "c", "b"};
+	EXPECT_EQ(*set.begin(), "c");
+	EXPECT_EQ(set.Count("b"), 1u);
+}
+
+TEST(FlatMapTest, MatchesStdMap) {
+	FlatMap<int, std::string> map;
+	std::map<int, std::string> model;
+	for (int i = 0; i < 200; ++i) {
+		const int key = i * 37 % 101;
+		map.TryEmplace(key, std::to_string(i));
+		model.try_emplace(key, std::to_string(i));
+	}
+	ASSERT_EQ(map.Size(), model.size());
+	auto it = map.begin();
+	for (const auto &[key, value] : model) {
+		EXPECT_EQ(it->first, key);
+		EXPECT_EQ(it->second, value);
+		++it;
+	}
+	EXPECT_EQ(map.Keys().Size(), map.Values().Size());
+}
+
+TEST(FlatMapTest, AssignAccessAndErase) {
+	FlatMap<std::string, int> map {{"b", 2}, {"a", 1}, {"b", 3}};
+	EXPECT_EQ(map.At("b"), 2);
+	EXPECT_FALSE(map.TryEmplace("a", 10).second);
+	EXPECT_EQ(map.At("a"), 1);
+	EXPECT_FALSE(map.InsertOrAssign("a", 10).second);
+	EXPECT_EQ(map.At("a"), 10);
+	map["c"] += 5;
+	EXPECT_EQ(map.At("c"), 5);
+	EXPECT_THROW(map.At("z"), std::out_of_range);
+	map.Insert({{"d", 4}, {"a", 0}});
+	EXPECT_EQ(map.At("a"), 10);
+	EXPECT_EQ(map.Erase("b"), 1u);
+	EXPECT_FALSE(map.Contains("b"));
+	EXPECT_EQ(map.Size(), 3u);
+	EXPECT_EQ((*map.Find("d")).second, 4);
+}
+
+TEST(FlatMapTest, UsesGivenAllocators) {
+	using KeyAlloc = TaggedAllocator<int>;
+	using ValueAlloc = TaggedAllocator<std::string>;
+	using Map = FlatMap<int, std::string, std::less<int>, KeyAlloc, ValueAlloc>;
+	{
+		Map map({{3, "c"}, {1, "a"}}, std::less<int>(), KeyAlloc(1), ValueAlloc(2));
+		EXPECT_EQ(map.Keys().GetAllocator().Id(), 1);
+		EXPECT_EQ(map.Values().GetAllocator().Id(), 2);
+		const std::vector<std::pair<int, std::string>> items {{2, "b"}, {0, "z"}};
+		map.Insert(items.begin(), items.end());
+		EXPECT_EQ(map.Keys().GetAllocator().Id(), 1);
+		EXPECT_EQ(map.Values().GetAllocator().Id(), 2);
+		EXPECT_EQ(std::vector<int>(map.Keys().begin(), map.Keys().end()), (std::vector<int> {0, 1, 2, 3}));
+
+		Map empty(std::less<int>(), KeyAlloc(4), ValueAlloc(5));
+		EXPECT_EQ(empty.Keys().GetAllocator().Id(), 4);
+		EXPECT_EQ(empty.Values().GetAllocator().Id(), 5);
+	}
+	EXPECT_EQ(KeyAlloc::LiveBlocks(), 0u);
+	EXPECT_EQ(ValueAlloc::LiveBlocks(), 0u);
+	EXPECT_EQ((TaggedAllocator<std::pair<int, std::string>>::LiveBlocks()), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,107 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "test_helpers.h"
+#include "vector.h"
+
+// Собирается с VECTOR_HARDENED=1: каждая проверка режима должна аварийно завершать процесс
+static_assert(VECTOR_HARDENED, "hardened tests must be built with VECTOR_HARDENED=1");
+
+namespace {
+
+class HardenedVectorTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		::testing::FLAGS_gtest_death_test_style = "threadsafe";
+	}
+};
+
+TEST_F(HardenedVectorTest, IndexOutOfRange) {
+	Vector<int> v {1, 2, 3};
+	EXPECT_DEATH(v[3] = 0, "index out of range");
+	const Vector<int> &cv = v;
+	EXPECT_DEATH((void)cv[100], "index out of range");
+	EXPECT_EQ(v[2], 3);
+}
+
+TEST_F(HardenedVectorTest, PopBackOnEmpty) {
+	Vector<std::string> v;
+	EXPECT_DEATH(v.PopBack(), "PopBack on an empty vector");
+}
+
+TEST_F(HardenedVectorTest, EraseOutsideVector) {
+	Vector<int> v {1, 2, 3};
+	EXPECT_DEATH(v.Erase(v.end()), "Erase\\(end\\(\\)\\)");
+	EXPECT_DEATH(v.SwapErase(v.end()), "SwapErase\\(end\\(\\)\\)");
+	EXPECT_DEATH(v.Erase(v.begin() + 2, v.begin() + 1), "reversed range");
+}
+
+TEST_F(HardenedVectorTest, IteratorInvalidatedByReallocation) {
+	Vector<int> v {1, 2, 3};
+	auto it = v.begin();
+	v.Reserve(100);
+	EXPECT_DEATH((void)*it, "after the buffer was reallocated");
+	auto fresh = v.begin();
+	v.Swap(v);
+	EXPECT_DEATH((void)*fresh, "after the buffer was reallocated");
+}
+
+TEST_F(HardenedVectorTest, IteratorOfAnotherVector) {
+	Vector<int> a {1, 2};
+	Vector<int> b {3, 4};
+	EXPECT_DEATH(a.Insert(b.begin(), 0), "another vector");
+	EXPECT_DEATH((void)(a.begin() == b.begin()), "different vectors");
+	EXPECT_DEATH((void)*a.end(), "");
+	Vector<int>::iterator singular;
+	EXPECT_DEATH((void)*singular, "singular iterator");
+}
+
+TEST_F(HardenedVectorTest, ValidUseStillWorks) {
+	Vector<std::string> v;
+	for (int i = 0; i < 20; ++i) {
+		v.PushBack(std::to_string(i));
+	}
+	auto it = v.Insert(v.begin() + 5, "x");
+	EXPECT_EQ(*it, "x");
+	it = v.Erase(it);
+	EXPECT_EQ(*it, "5");
+	EXPECT_EQ(v.end() - v.begin(), 20);
+}
+
+#if VECTOR_ASAN
+
+// Под AddressSanitizer свободная ёмкость отравлена
+TEST_F(HardenedVectorTest, SpareCapacityIsPoisoned) {
+	Vector<int> v {1, 2};
+	v.Reserve(16);
+	int *data = v.Data();
+	EXPECT_DEATH((void)*(volatile int*)(data + 2), "container-overflow");
+	v.PushBack(3);
+	EXPECT_EQ(data[2], 3);
+	v.PopBack();
+	EXPECT_DEATH((void)*(volatile int*)(data + 2), "container-overflow");
+}
+
+TEST_F(HardenedVectorTest, SpareCapacityPoisonedAgainAfterThrow) {
+	Tracked::Reset();
+	{
+		Vector<Tracked> v;
+		v.Reserve(8);
+		v.EmplaceBack(1);
+		v.EmplaceBack(2);
+		const Tracked value(3);
+		Tracked::copies_until_throw = 1;
+		EXPECT_THROW(v.Insert(v.end(), 3, value), std::runtime_error);
+		Tracked::copies_until_throw = -1;
+		Tracked *data = v.Data();
+		EXPECT_EQ(v.Size(), 2u);
+		EXPECT_DEATH((void)*(volatile int*)&data[2].value, "container-overflow");
+	}
+	EXPECT_EQ(Tracked::alive, 0);
+}
+
+#endif
+
+}  // namespace
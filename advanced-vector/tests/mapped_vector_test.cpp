@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include "mapped_vector.h"
+
+namespace {
+
+struct Record {
+	uint64_t id;
+	double value;
+};
+
+class MappedVectorTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		path_ = ::testing::TempDir() + "mapped_vector_test_"
+				+ ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin";
+		std::remove(path_.c_str());
+	}
+
+	void TearDown() override {
+		std::remove(path_.c_str());
+	}
+
+	size_t FileSize() const {
+		struct stat info;
+		return ::stat(path_.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+	}
+
+	std::string path_;
+};
+
+TEST_F(MappedVectorTest, ContentsPersistAcrossReopen) {
+	{
+		MappedVector<Record> v(path_);
+		EXPECT_TRUE(v.IsOpen());
+		EXPECT_EQ(v.Size(), 0u);
+		for (uint64_t i = 0; i < 10000; ++i) {
+			v.PushBack({i, i * 0.25});
+		}
+		v.Sync();
+	}
+	// При закрытии файл обрезается до Size() записей
+	EXPECT_EQ(FileSize(), 10000 * sizeof(Record));
+
+	MappedVector<Record> v(path_);
+	ASSERT_EQ(v.Size(), 10000u);
+	v.Advise(MappedAccess::kSequential);
+	for (uint64_t i = 0; i < 10000; ++i) {
+		ASSERT_EQ(v[i].id, i);
+		ASSERT_EQ(v[i].value, i * 0.25);
+	}
+	v.EmplaceBack(v[0]);
+	EXPECT_EQ(v[10000].id, 0u);
+}
+
+TEST_F(MappedVectorTest, ResizeAndMove) {
+	MappedVector<int> v(path_);
+	v.Resize(100);
+	EXPECT_EQ(v[99], 0);
+	v[99] = 7;
+	MappedVector<int> moved(std::move(v));
+	EXPECT_FALSE(v.IsOpen());
+	EXPECT_EQ(moved[99], 7);
+	moved.PopBack();
+	moved.Clear();
+	EXPECT_EQ(moved.Size(), 0u);
+}
+
+TEST_F(MappedVectorTest, RejectsFileWithPartialRecord) {
+	{
+		MappedVector<char> bytes(path_);
+		for (char c : std::string("abc")) {
+			bytes.PushBack(c);
+		}
+	}
+	EXPECT_THROW(MappedVector<Record> records(path_), std::runtime_error);
+}
+
+}  // namespace
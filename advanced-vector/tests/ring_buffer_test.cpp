@@ -0,0 +1,97 @@
+#include <array>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ring_buffer.h"
+
+namespace {
+
+TEST(RingBufferTest, WrapsAroundAndGrowsInOrder) {
+	RingBuffer<int> ring(4);
+	EXPECT_EQ(ring.Capacity(), 4u);
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_TRUE(ring.TryPush(i));
+	}
+	int out = -1;
+	EXPECT_TRUE(ring.TryPop(out));
+	EXPECT_EQ(out, 0);
+	EXPECT_TRUE(ring.TryPop(out));
+	for (int i = 3; i < 6; ++i) {
+		EXPECT_TRUE(ring.TryPush(i));
+	}
+	EXPECT_TRUE(ring.Full());
+	EXPECT_FALSE(ring.TryPush(100));
+	// Очередь продолжается через границу буфера и переносится в новый при росте
+	ring.PushBack(6);
+	EXPECT_EQ(ring.Capacity(), 8u);
+	std::array<int, 8> items {};
+	EXPECT_EQ(ring.PopBatch(items), 5u);
+	EXPECT_EQ(std::vector<int>(items.begin(), items.begin() + 5), (std::vector<int> {2, 3, 4, 5, 6}));
+	EXPECT_TRUE(ring.Empty());
+}
+
+TEST(RingBufferTest, BatchesCrossBufferBoundary) {
+	RingBuffer<int> ring(8);
+	std::array<int, 6> first {1, 2, 3, 4, 5, 6};
+	EXPECT_EQ(ring.PushBatch(first), 6u);
+	std::array<int, 5> popped {};
+	EXPECT_EQ(ring.PopBatch(popped), 5u);
+	std::array<int, 10> second {7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+	EXPECT_EQ(ring.PushBatch(second), 7u);
+	EXPECT_EQ(ring.Front(), 6);
+	EXPECT_EQ(ring.Back(), 13);
+	EXPECT_EQ(ring[3], 9);
+}
+
+TEST(RingBufferTest, EmplaceCopyOfOwnElementWhenFull) {
+	RingBuffer<std::string> ring(2);
+	ring.PushBack(std::string(40, 'a'));
+	ring.PushBack(std::string(40, 'b'));
+	ring.EmplaceBack(ring.Front());
+	EXPECT_EQ(ring.Size(), 3u);
+	EXPECT_EQ(ring.Back(), std::string(40, 'a'));
+	ring.Clear();
+	EXPECT_TRUE(ring.Empty());
+}
+
+TEST(SpscRingBufferTest, ConsumerSeesProducerOrder) {
+	constexpr int kCount = 200000;
+	SpscRingBuffer<int> ring(1024);
+	std::thread producer([&ring] {
+		int next = 0;
+		std::array<int, 64> batch {};
+		while (next < kCount) {
+			if (next % 3 == 0) {
+				if (ring.TryPush(next)) {
+					++next;
+				}
+				continue;
+			}
+			const int count = std::min<int>(batch.size(), kCount - next);
+			for (int i = 0; i < count; ++i) {
+				batch[i] = next + i;
+			}
+			next += int(ring.PushBatch(std::span<const int>(batch.data(), count)));
+		}
+	});
+	int expected = 0;
+	std::array<int, 50> out {};
+	while (expected < kCount) {
+		const size_t count = ring.PopBatch(out);
+		for (size_t i = 0; i < count; ++i) {
+			ASSERT_EQ(out[i], expected++);
+		}
+		int item = 0;
+		if (ring.TryPop(item)) {
+			ASSERT_EQ(item, expected++);
+		}
+	}
+	producer.join();
+	EXPECT_EQ(ring.Size(), 0u);
+}
+
+}  // namespace
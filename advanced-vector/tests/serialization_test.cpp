@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "test_helpers.h"
+#include "vector_serialization.h"
+
+namespace {
+
+// Временный файл, который удаляется при закрытии
+class TempFile {
+public:
+	TempFile() :
+			file_(std::tmpfile()) {
+	}
+
+	TempFile(const TempFile&) = delete;
+	TempFile& operator=(const TempFile&) = delete;
+
+	~TempFile() {
+		std::fclose(file_);
+	}
+
+	int Fd() const noexcept {
+		return fileno(file_);
+	}
+
+	void Rewind() const {
+		ASSERT_EQ(::lseek(Fd(), 0, SEEK_SET), 0);
+	}
+
+private:
+	std::FILE *file_;
+};
+
+class Pipe {
+public:
+	Pipe() {
+		EXPECT_EQ(::pipe(fds_), 0);
+	}
+
+	Pipe(const Pipe&) = delete;
+	Pipe& operator=(const Pipe&) = delete;
+
+	~Pipe() {
+		CloseWriter();
+		::close(fds_[0]);
+	}
+
+	int Reader() const noexcept {
+		return fds_[0];
+	}
+
+	int Writer() const noexcept {
+		return fds_[1];
+	}
+
+	void CloseWriter() noexcept {
+		if (fds_[1] >= 0) {
+			::close(fds_[1]);
+			fds_[1] = -1;
+		}
+	}
+
+private:
+	int fds_[2] = {-1, -1};
+};
+
+TEST(SerializationTest, TrivialRoundTripThroughFile) {
+	Vector<double> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.PushBack(i * 1.5);
+	}
+	TempFile file;
+	Serialize(file.Fd(), v);
+	file.Rewind();
+	Vector<double> restored = Deserialize<double>(file.Fd());
+	ASSERT_EQ(restored.Size(), v.Size());
+	EXPECT_TRUE(std::equal(v.begin(), v.end(), restored.begin()));
+}
+
+TEST(SerializationTest, StringsRoundTripThroughPipe) {
+	Vector<std::string> v {"", "short", std::string(100, 'x')};
+	Pipe pipe;
+	Serialize(pipe.Writer(), v);
+	Vector<std::string> restored = Deserialize<std::string>(pipe.Reader());
+	ASSERT_EQ(restored.Size(), 3u);
+	EXPECT_EQ(restored[0], "");
+	EXPECT_EQ(restored[1], "short");
+	EXPECT_EQ(restored[2], std::string(100, 'x'));
+}
+
+TEST(SerializationTest, LargePayloadThroughPipe) {
+	Vector<int> v(500000);
+	for (size_t i = 0; i < v.Size(); ++i) {
+		v[i] = int(i);
+	}
+	Pipe pipe;
+	std::thread writer([&v, &pipe] {
+		Serialize(pipe.Writer(), v);
+	});
+	Vector<int> restored = Deserialize<int>(pipe.Reader());
+	writer.join();
+	ASSERT_EQ(restored.Size(), v.Size());
+	EXPECT_TRUE(std::equal(v.begin(), v.end(), restored.begin()));
+}
+
+TEST(SerializationTest, ForwardsAllocator) {
+	using Alloc = TaggedAllocator<int>;
+	Vector<int> v {1, 2, 3};
+	TempFile file;
+	Serialize(file.Fd(), v);
+	file.Rewind();
+	Vector<int, Alloc> restored = Deserialize<int>(file.Fd(), Alloc(3));
+	EXPECT_EQ(restored.GetAllocator().Id(), 3);
+	EXPECT_EQ(restored[2], 3);
+}
+
+TEST(SerializationTest, RejectsSizeLongerThanFile) {
+	VectorWireHeader header;
+	header.alignment = alignof(int);
+	header.element_size = sizeof(int);
+	header.size = uint64_t(1) << 40;
+	header.payload_bytes = header.size * sizeof(int);
+	TempFile file;
+	ASSERT_EQ(::write(file.Fd(), &header, sizeof(header)), ssize_t(sizeof(header)));
+	ASSERT_EQ(::write(file.Fd(), "abcd", 4), 4);
+	file.Rewind();
+	EXPECT_THROW(Deserialize<int>(file.Fd()), std::runtime_error);
+}
+
+TEST(SerializationTest, TruncatedStreamFailsWithoutHugeAllocation) {
+	VectorWireHeader header;
+	header.alignment = alignof(int);
+	header.element_size = sizeof(int);
+	header.size = uint64_t(1) << 40;
+	header.payload_bytes = header.size * sizeof(int);
+	Pipe pipe;
+	ASSERT_EQ(::write(pipe.Writer(), &header, sizeof(header)), ssize_t(sizeof(header)));
+	ASSERT_EQ(::write(pipe.Writer(), "abcd", 4), 4);
+	pipe.CloseWriter();
+	EXPECT_THROW(Deserialize<int>(pipe.Reader()), std::runtime_error);
+}
+
+TEST(SerializationTest, RejectsTrailingPayloadAndTypeMismatch) {
+	Vector<std::string> v {"a", "b"};
+	TempFile file;
+	Serialize(file.Fd(), v);
+	// Заголовок обещает на один элемент меньше, чем записано в нагрузке
+	const uint64_t size = 1;
+	ASSERT_EQ(::pwrite(file.Fd(), &size, sizeof(size), offsetof(VectorWireHeader, size)), ssize_t(sizeof(size)));
+	file.Rewind();
+	EXPECT_THROW(Deserialize<std::string>(file.Fd()), std::runtime_error);
+
+	TempFile numbers;
+	Serialize(numbers.Fd(), Vector<int> {1, 2});
+	numbers.Rewind();
+	EXPECT_THROW(Deserialize<double>(numbers.Fd()), std::runtime_error);
+}
+
+// Запоминает наибольший запрошенный блок
+template<typename T>
+struct LargestRequestAllocator : std::allocator<T> {
+	static inline size_t largest = 0;
+
+	template<typename U>
+	struct rebind {
+		using other = LargestRequestAllocator<U>;
+	};
+
+	LargestRequestAllocator() = default;
+
+	template<typename U>
+	LargestRequestAllocator(const LargestRequestAllocator<U>&) noexcept {
+	}
+
+	T* allocate(size_t n) {
+		largest = std::max(largest, n);
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+TEST(SerializationTest, ReserveForStringsIsBoundedByLengthPrefixes) {
+	Vector<std::string> v(100);
+	TempFile file;
+	Serialize(file.Fd(), v);
+	// Нагрузка из 800 байт вмещает не больше 100 строк: у каждой есть восьмибайтовая длина
+	const uint64_t size = uint64_t(1) << 40;
+	ASSERT_EQ(::pwrite(file.Fd(), &size, sizeof(size), offsetof(VectorWireHeader, size)), ssize_t(sizeof(size)));
+	file.Rewind();
+	using Alloc = LargestRequestAllocator<std::string>;
+	EXPECT_THROW((Deserialize<std::string, Alloc>(file.Fd())), std::runtime_error);
+	EXPECT_LE(Alloc::largest, 100u);
+}
+
+}  // namespace
@@ -0,0 +1,167 @@
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "small_vector.h"
+#include "test_helpers.h"
+
+namespace {
+
+class SmallVectorTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		Tracked::Reset();
+	}
+
+	void TearDown() override {
+		EXPECT_EQ(Tracked::alive, 0);
+	}
+};
+
+TEST_F(SmallVectorTest, StaysInlineUpToN) {
+	SmallVector<int, 4> v;
+	EXPECT_TRUE(v.IsInline());
+	EXPECT_EQ(v.Capacity(), 4u);
+	for (int i = 0; i < 4; ++i) {
+		v.PushBack(i);
+	}
+	EXPECT_TRUE(v.IsInline());
+	v.PushBack(4);
+	EXPECT_FALSE(v.IsInline());
+	EXPECT_GE(v.Capacity(), 5u);
+	EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int> {0, 1, 2, 3, 4}));
+}
+
+TEST_F(SmallVectorTest, CopyAndMoveInlineAndHeap) {
+	SmallVector<Tracked, 2> inline_items;
+	inline_items.EmplaceBack(1);
+	SmallVector<Tracked, 2> heap_items;
+	for (int i = 0; i < 5; ++i) {
+		heap_items.EmplaceBack(i);
+	}
+
+	SmallVector<Tracked, 2> moved_inline(std::move(inline_items));
+	EXPECT_TRUE(moved_inline.IsInline());
+	EXPECT_EQ(ValuesOf(moved_inline), (std::vector<int> {1}));
+
+	const Tracked *heap_data = &heap_items[0];
+	SmallVector<Tracked, 2> moved_heap(std::move(heap_items));
+	// Буфер в куче передаётся без переноса элементов
+	EXPECT_EQ(&moved_heap[0], heap_data);
+
+	SmallVector<Tracked, 2> copy(moved_heap);
+	EXPECT_EQ(ValuesOf(copy), (std::vector<int> {0, 1, 2, 3, 4}));
+	copy = moved_inline;
+	EXPECT_EQ(ValuesOf(copy), (std::vector<int> {1}));
+	copy.Swap(moved_heap);
+	EXPECT_EQ(ValuesOf(copy), (std::vector<int> {0, 1, 2, 3, 4}));
+	EXPECT_EQ(ValuesOf(moved_heap), (std::vector<int> {1}));
+}
+
+TEST_F(SmallVectorTest, SwapInlineAndHeap) {
+	SmallVector<Tracked, 4> a;
+	SmallVector<Tracked, 4> b;
+	for (int i = 0; i < 3; ++i) {
+		a.EmplaceBack(i);
+	}
+	b.EmplaceBack(10);
+	a.Swap(b);
+	EXPECT_EQ(ValuesOf(a), (std::vector<int> {10}));
+	EXPECT_EQ(ValuesOf(b), (std::vector<int> {0, 1, 2}));
+
+	for (int i = 0; i < 5; ++i) {
+		a.EmplaceBack(11 + i);
+	}
+	ASSERT_FALSE(a.IsInline());
+	const Tracked *heap_data = &a[0];
+	Tracked::moves = 0;
+	a.Swap(b);
+	// Буфер в куче переходит к b, а три встроенных элемента b переносятся во встроенный буфер a
+	EXPECT_TRUE(a.IsInline());
+	EXPECT_EQ(&b[0], heap_data);
+	EXPECT_EQ(Tracked::moves, 3);
+	EXPECT_EQ(Tracked::copies, 0);
+	EXPECT_EQ(ValuesOf(a), (std::vector<int> {0, 1, 2}));
+	EXPECT_EQ(ValuesOf(b), (std::vector<int> {10, 11, 12, 13, 14, 15}));
+
+	b.Swap(a);
+	EXPECT_EQ(ValuesOf(a), (std::vector<int> {10, 11, 12, 13, 14, 15}));
+	EXPECT_EQ(ValuesOf(b), (std::vector<int> {0, 1, 2}));
+}
+
+TEST_F(SmallVectorTest, MoveAssignmentRespectsAllocator) {
+	static_assert(std::is_nothrow_move_assignable_v<SmallVector<Tracked, 2>>);
+	static_assert(!std::is_nothrow_move_assignable_v<SmallVector<Tracked, 2, TaggedAllocator<Tracked>>>);
+	using Alloc = TaggedAllocator<Tracked>;
+	{
+		SmallVector<Tracked, 2, Alloc> source(Alloc(1));
+		SmallVector<Tracked, 2, Alloc> target(Alloc(2));
+		for (int i = 0; i < 5; ++i) {
+			source.EmplaceBack(i);
+		}
+		target = std::move(source);
+		// Аллокаторы не равны и не распространяются: элементы переносятся в буфер target
+		EXPECT_EQ(target.GetAllocator().Id(), 2);
+		EXPECT_EQ(ValuesOf(target), (std::vector<int> {0, 1, 2, 3, 4}));
+		EXPECT_EQ(Tracked::copies, 0);
+	}
+	using PropagatingAlloc = TaggedAllocator<Tracked, true>;
+	{
+		SmallVector<Tracked, 2, PropagatingAlloc> source(PropagatingAlloc(1));
+		SmallVector<Tracked, 2, PropagatingAlloc> target(PropagatingAlloc(2));
+		for (int i = 0; i < 5; ++i) {
+			source.EmplaceBack(i);
+			target.EmplaceBack(-i);
+		}
+		const Tracked *heap_data = &source[0];
+		target = std::move(source);
+		EXPECT_EQ(target.GetAllocator().Id(), 1);
+		EXPECT_EQ(&target[0], heap_data);
+
+		SmallVector<Tracked, 2, PropagatingAlloc> small(PropagatingAlloc(3));
+		small.EmplaceBack(7);
+		target = std::move(small);
+		EXPECT_TRUE(target.IsInline());
+		EXPECT_EQ(target.GetAllocator().Id(), 3);
+		EXPECT_EQ(ValuesOf(target), (std::vector<int> {7}));
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+TEST_F(SmallVectorTest, CopyAndSwapPropagateAllocator) {
+	using Alloc = TaggedAllocator<int, true>;
+	{
+		SmallVector<int, 2, Alloc> a(Alloc(1));
+		SmallVector<int, 2, Alloc> b(Alloc(2));
+		a.PushBack(1);
+		for (int i = 0; i < 3; ++i) {
+			b.PushBack(i);
+		}
+		a.Swap(b);
+		EXPECT_EQ(a.GetAllocator().Id(), 2);
+		EXPECT_EQ(b.GetAllocator().Id(), 1);
+		EXPECT_EQ(a.Size(), 3u);
+		EXPECT_TRUE(b.IsInline());
+		b = a;
+		EXPECT_EQ(b.GetAllocator().Id(), 2);
+		EXPECT_EQ(b[2], 2);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+TEST_F(SmallVectorTest, ResizeAndErase) {
+	SmallVector<std::string, 3> v(2);
+	v.Resize(6);
+	EXPECT_EQ(v.Size(), 6u);
+	v[5] = "last";
+	v.Erase(v.begin());
+	EXPECT_EQ(v[4], "last");
+	v.Resize(1);
+	EXPECT_EQ(v.Size(), 1u);
+	v.PopBack();
+	EXPECT_EQ(v.Size(), 0u);
+}
+
+}  // namespace
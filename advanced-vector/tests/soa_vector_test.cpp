@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include <gtest/gtest.h>
+
+#include "soa_vector.h"
+
+namespace {
+
+TEST(SoAVectorTest, ColumnsAreContiguousAndAligned) {
+	SoAVector<float, int32_t, double> v;
+	for (int i = 0; i < 100; ++i) {
+		auto [x, id, weight] = v.EmplaceBack(float(i), i, i * 0.5);
+		EXPECT_EQ(id, i);
+		x += 1;
+	}
+	auto xs = v.Column<0>();
+	auto ids = v.Column<1>();
+	auto weights = v.Column<2>();
+	ASSERT_EQ(xs.size(), 100u);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(xs.data()) % 64, 0u);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(ids.data()) % 64, 0u);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(weights.data()) % 64, 0u);
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_EQ(xs[i], float(i + 1));
+		EXPECT_EQ(ids[i], i);
+		EXPECT_EQ(std::get<2>(v[i]), i * 0.5);
+	}
+}
+
+TEST(SoAVectorTest, EmplaceBackCopiesOwnRowDuringGrowth) {
+	SoAVector<std::string, int> v;
+	v.EmplaceBack(std::string(40, 'x'), 1);
+	while (v.Size() != v.Capacity()) {
+		v.EmplaceBack("filler", 0);
+	}
+	v.EmplaceBack(std::get<0>(v[0]), std::get<1>(v[0]));
+	EXPECT_EQ(std::get<0>(v[v.Size() - 1]), std::string(40, 'x'));
+	EXPECT_EQ(std::get<1>(v[v.Size() - 1]), 1);
+}
+
+TEST(SoAVectorTest, CopyResizeAndPop) {
+	SoAVector<std::string, int> v(3);
+	std::get<0>(v[2]) = "third";
+	SoAVector<std::string, int> copy(v);
+	copy.Resize(10);
+	EXPECT_EQ(copy.Size(), 10u);
+	EXPECT_EQ(std::get<0>(copy[2]), "third");
+	EXPECT_EQ(std::get<1>(copy[9]), 0);
+	copy.PopBack();
+	copy.Resize(3);
+	EXPECT_EQ(copy.Size(), 3u);
+	v = std::move(copy);
+	EXPECT_EQ(v.Size(), 3u);
+	v.Clear();
+	EXPECT_EQ(v.Size(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,81 @@
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "static_vector.h"
+#include "vector.h"
+
+namespace {
+
+constexpr int StaticVectorSum() {
+	StaticVector<int, 8> v {1, 2, 3};
+	v.Emplace(v.begin(), v[2]);
+	v.Erase(v.begin() + 1);
+	v.Insert(v.end(), 10);
+	int sum = 0;
+	for (int x : v) {
+		sum += x;
+	}
+	return sum;
+}
+
+constexpr int VectorSum() {
+	Vector<int> v;
+	for (int i = 0; i < 10; ++i) {
+		v.PushBack(i);
+	}
+	v.Emplace(v.begin(), v[9]);
+	v.Erase(v.begin() + 1, v.begin() + 3);
+	v.Insert(v.begin(), 2, 100);
+	Vector<int> copy = v;
+	copy.Resize(copy.Size() + 1);
+	int sum = 0;
+	for (int x : copy) {
+		sum += x;
+	}
+	return sum;
+}
+
+// Таблица, построенная при компиляции
+constexpr StaticVector<int, 16> Squares() {
+	StaticVector<int, 16> v;
+	for (int i = 0; i < 16; ++i) {
+		v.PushBack(i * i);
+	}
+	return v;
+}
+
+// Контейнеры, которые работают в константных выражениях
+static_assert(StaticVectorSum() == 3 + 2 + 3 + 10);
+static_assert(VectorSum() == 9 + (45 - 0 - 1) + 200);
+static_assert(Squares()[15] == 225 && Squares().Size() == 16);
+static_assert(std::is_trivially_copyable_v<StaticVector<int, 8>>);
+static_assert(!std::is_trivially_copyable_v<StaticVector<std::string, 8>>);
+
+TEST(StaticVectorTest, ThrowsWhenFull) {
+	StaticVector<std::string, 3> v {"a", "b", "c"};
+	EXPECT_THROW(v.PushBack("d"), std::length_error);
+	EXPECT_THROW(v.Emplace(v.begin(), "d"), std::length_error);
+	EXPECT_THROW(v.Resize(4), std::length_error);
+	EXPECT_THROW((StaticVector<int, 2> {1, 2, 3}), std::length_error);
+	EXPECT_EQ(std::vector<std::string>(v.begin(), v.end()), (std::vector<std::string> {"a", "b", "c"}));
+	EXPECT_EQ(v.Capacity(), 3u);
+}
+
+TEST(StaticVectorTest, CopyMoveAndRangeErase) {
+	StaticVector<std::string, 8> v {"a", "b", "c", "d", "e"};
+	StaticVector<std::string, 8> copy(v);
+	v.Erase(v.begin() + 1, v.begin() + 3);
+	EXPECT_EQ(std::vector<std::string>(v.begin(), v.end()), (std::vector<std::string> {"a", "d", "e"}));
+	copy = std::move(v);
+	EXPECT_EQ(copy.Size(), 3u);
+	copy.Resize(6);
+	EXPECT_EQ(copy[5], "");
+	copy.Clear();
+	EXPECT_EQ(copy.Size(), 0u);
+}
+
+}  // namespace
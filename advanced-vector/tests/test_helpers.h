@@ -0,0 +1,164 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Элемент, считающий живые объекты, копирования и перемещения. Копирование бросает исключение,
+// когда счётчик copies_until_throw доходит до нуля; отрицательное значение отключает броски.
+// kNothrowMove = false даёт тип с потенциально бросающим перемещением, которое вектор не должен использовать
+template<bool kNothrowMove>
+struct BasicTracked {
+	static inline int alive = 0;
+	static inline int copies = 0;
+	static inline int moves = 0;
+	static inline int copies_until_throw = -1;
+
+	static void Reset() noexcept {
+		alive = copies = moves = 0;
+		copies_until_throw = -1;
+	}
+
+	BasicTracked() noexcept :
+			BasicTracked(0) {
+	}
+
+	BasicTracked(int value) noexcept :
+			value(value) {
+		++alive;
+	}
+
+	BasicTracked(const BasicTracked &other) :
+			value(other.value) {
+		CountCopy();
+		++alive;
+	}
+
+	BasicTracked(BasicTracked &&other) noexcept(kNothrowMove) :
+			value(std::exchange(other.value, -1)) {
+		++moves;
+		++alive;
+	}
+
+	BasicTracked& operator=(const BasicTracked &other) {
+		CountCopy();
+		value = other.value;
+		return *this;
+	}
+
+	BasicTracked& operator=(BasicTracked &&other) noexcept(kNothrowMove) {
+		++moves;
+		value = std::exchange(other.value, -1);
+		return *this;
+	}
+
+	~BasicTracked() {
+		--alive;
+	}
+
+	bool operator==(const BasicTracked &other) const noexcept {
+		return value == other.value;
+	}
+
+	int value;
+
+private:
+	static void CountCopy() {
+		if (copies_until_throw == 0) {
+			throw std::runtime_error("copy failed");
+		}
+		if (copies_until_throw > 0) {
+			--copies_until_throw;
+		}
+		++copies;
+	}
+};
+
+using Tracked = BasicTracked<true>;
+using TrackedThrowingMove = BasicTracked<false>;
+
+template<typename T>
+std::vector<int> ValuesOf(const T &container) {
+	std::vector<int> values;
+	for (const auto &item : container) {
+		values.push_back(item.value);
+	}
+	return values;
+}
+
+// Аллокатор с идентификатором: экземпляры с разными id не равны. Каждый блок запоминает id выделившего
+// его аллокатора, и освобождение чужим аллокатором отмечается как ошибка теста
+template<typename T, bool kPropagate = false, bool kAlwaysEqual = false>
+class TaggedAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::bool_constant<kPropagate>;
+	using propagate_on_container_move_assignment = std::bool_constant<kPropagate>;
+	using propagate_on_container_swap = std::bool_constant<kPropagate>;
+	using is_always_equal = std::bool_constant<kAlwaysEqual>;
+
+	template<typename U>
+	struct rebind {
+		using other = TaggedAllocator<U, kPropagate, kAlwaysEqual>;
+	};
+
+	explicit TaggedAllocator(int id = 0) noexcept :
+			id_(id) {
+	}
+
+	template<typename U>
+	TaggedAllocator(const TaggedAllocator<U, kPropagate, kAlwaysEqual> &other) noexcept :
+			id_(other.Id()) {
+	}
+
+	T* allocate(size_t n) {
+		T *p = std::allocator<T>().allocate(n);
+		Owners()[p] = id_;
+		return p;
+	}
+
+	void deallocate(T *p, size_t n) noexcept {
+		auto it = Owners().find(p);
+		if (it == Owners().end()) {
+			ADD_FAILURE() << "deallocating a block that was not allocated by TaggedAllocator";
+		} else {
+			if (!kAlwaysEqual && it->second != id_) {
+				ADD_FAILURE() << "block of allocator " << it->second << " returned to allocator " << id_;
+			}
+			Owners().erase(it);
+		}
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	int Id() const noexcept {
+		return id_;
+	}
+
+	// Число блоков всех TaggedAllocator, которые ещё не освобождены
+	static size_t LiveBlocks() noexcept {
+		return Owners().size();
+	}
+
+	template<typename U>
+	bool operator==(const TaggedAllocator<U, kPropagate, kAlwaysEqual> &other) const noexcept {
+		return kAlwaysEqual || id_ == other.Id();
+	}
+
+	template<typename U>
+	bool operator!=(const TaggedAllocator<U, kPropagate, kAlwaysEqual> &other) const noexcept {
+		return !(*this == other);
+	}
+
+private:
+	static std::map<const void*, int>& Owners() noexcept {
+		static std::map<const void*, int> owners;
+		return owners;
+	}
+
+	int id_;
+};
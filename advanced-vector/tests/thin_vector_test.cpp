@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "test_helpers.h"
+#include "thin_vector.h"
+
+namespace {
+
+static_assert(sizeof(ThinVector<int>) == sizeof(void*));
+static_assert(sizeof(ThinVector<std::string, std::allocator<std::string>, uint32_t>) == sizeof(void*));
+
+TEST(ThinVectorTest, EmptyVectorDoesNotAllocate) {
+	ThinVector<int> v;
+	EXPECT_EQ(v.Size(), 0u);
+	EXPECT_EQ(v.Capacity(), 0u);
+	EXPECT_EQ(v.begin(), v.end());
+	v.Reserve(10);
+	EXPECT_EQ(v.Capacity(), 10u);
+	v.ShrinkToFit();
+	EXPECT_EQ(v.Capacity(), 0u);
+}
+
+TEST(ThinVectorTest, NarrowSizeTypeHoldsElements) {
+	ThinVector<std::string, std::allocator<std::string>, uint32_t> v {"a", "b"};
+	for (int i = 0; i < 1000; ++i) {
+		v.PushBack(std::to_string(i));
+	}
+	v.Emplace(v.begin() + 1, "inserted");
+	v.Erase(v.begin());
+	EXPECT_EQ(v.Size(), 1002u);
+	EXPECT_EQ(v[0], "inserted");
+	EXPECT_EQ(v[1001], "999");
+}
+
+TEST(ThinVectorTest, CopyMoveAndResize) {
+	Tracked::Reset();
+	{
+		ThinVector<Tracked> v(3);
+		v[2].value = 5;
+		ThinVector<Tracked> copy(v);
+		ThinVector<Tracked> moved(std::move(v));
+		EXPECT_EQ(v.Size(), 0u);
+		EXPECT_EQ(ValuesOf(moved), (std::vector<int> {0, 0, 5}));
+		copy.Resize(5);
+		copy.PopBack();
+		EXPECT_EQ(copy.Size(), 4u);
+		moved = copy;
+		EXPECT_EQ(ValuesOf(moved), (std::vector<int> {0, 0, 5, 0}));
+		moved.Swap(v);
+		EXPECT_EQ(v.Size(), 4u);
+		v.Clear();
+		EXPECT_EQ(v.Size(), 0u);
+	}
+	EXPECT_EQ(Tracked::alive, 0);
+}
+
+}  // namespace
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "vector.h"
+#include "vector_algorithms.h"
+
+namespace {
+
+// Целые значения небольшой величины: сумма в float не зависит от порядка сложения
+template<typename T>
+Vector<T> Pattern(size_t size, int seed) {
+	Vector<T> v(size);
+	for (size_t i = 0; i < size; ++i) {
+		v[i] = T(int((i * 7 + seed) % 17) - 8);
+	}
+	return v;
+}
+
+template<typename T>
+class VectorAlgorithmsTest : public ::testing::Test {
+};
+
+using ElementTypes = ::testing::Types<float, int32_t, double, int64_t, uint8_t>;
+TYPED_TEST_SUITE(VectorAlgorithmsTest, ElementTypes);
+
+// Размеры захватывают пустой массив, хвосты короче регистра и несколько полных блоков
+TYPED_TEST(VectorAlgorithmsTest, MatchScalarReference) {
+	using T = TypeParam;
+	for (size_t size = 0; size < 100; ++size) {
+		const Vector<T> a = Pattern<T>(size, 3);
+		const Vector<T> b = Pattern<T>(size, 11);
+		const std::vector<T> ref_a(a.begin(), a.end());
+		const std::vector<T> ref_b(b.begin(), b.end());
+		EXPECT_EQ(Sum(a), std::accumulate(ref_a.begin(), ref_a.end(), T(0))) << size;
+		EXPECT_EQ(Dot(a, b), std::inner_product(ref_a.begin(), ref_a.end(), ref_b.begin(), T(0))) << size;
+		if (size != 0) {
+			EXPECT_EQ(Min(a), *std::min_element(ref_a.begin(), ref_a.end())) << size;
+			EXPECT_EQ(Max(a), *std::max_element(ref_a.begin(), ref_a.end())) << size;
+		}
+		for (int value : {-8, 0, 8, 100}) {
+			const T key = T(value);
+			EXPECT_EQ(Count(a, key), size_t(std::count(ref_a.begin(), ref_a.end(), key))) << size;
+			EXPECT_EQ(Find(a, key), size_t(std::find(ref_a.begin(), ref_a.end(), key) - ref_a.begin())) << size;
+		}
+	}
+}
+
+TYPED_TEST(VectorAlgorithmsTest, FindsLastElementAndFills) {
+	using T = TypeParam;
+	Vector<T> v(67);
+	Fill(AsSpan(v), T(1));
+	EXPECT_EQ(Count(v, T(1)), 67u);
+	v[66] = T(5);
+	EXPECT_EQ(Find(v, T(5)), 66u);
+	EXPECT_EQ(Max(v), T(5));
+	EXPECT_EQ(Min(v), T(1));
+}
+
+TEST(VectorAlgorithmsSpanTest, AcceptsMutableAndFixedExtentSpans) {
+	std::vector<float> values {3, 1, 4, 1, 5, 9, 2, 6};
+	std::span<float> all(values);
+	std::span<const float, 4> head(values.data(), 4);
+	EXPECT_EQ(Sum(all), 31.0f);
+	EXPECT_EQ(Sum(head), 9.0f);
+	EXPECT_EQ(Dot(all.first(2), head.first(2)), 10.0f);
+	EXPECT_EQ(Min(all), 1.0f);
+	EXPECT_EQ(Max(head), 4.0f);
+	// Значение подставляется без явного приведения к типу элемента
+	EXPECT_EQ(Count(all, 1), 2u);
+	EXPECT_EQ(Find(all, 9), 5u);
+	Fill(all.subspan(6), 0);
+	EXPECT_EQ(values[7], 0.0f);
+}
+
+TEST(VectorAlgorithmsSpanTest, CountOfLongArray) {
+	Vector<int32_t> v(1 << 20);
+	for (size_t i = 0; i < v.Size(); i += 3) {
+		v[i] = 7;
+	}
+	EXPECT_EQ(Count(v, 7), (v.Size() + 2) / 3);
+	EXPECT_EQ(Find(v, 1), v.Size());
+}
+
+}  // namespace
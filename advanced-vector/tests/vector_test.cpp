@@ -0,0 +1,510 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "allocators.h"
+#include "test_helpers.h"
+#include "vector.h"
+#include "vector_conversions.h"
+#include "vector_stats.h"
+
+namespace {
+
+// Элемент с нетривиальным перемещением, который помечен как тривиально перемещаемый:
+// вектор обязан переносить его побайтово, не вызывая конструктор перемещения
+struct Relocatable {
+	static inline int moves = 0;
+
+	explicit Relocatable(int value) noexcept :
+			value(value) {
+	}
+
+	Relocatable(Relocatable &&other) noexcept :
+			value(other.value) {
+		++moves;
+	}
+
+	Relocatable& operator=(Relocatable &&other) noexcept {
+		++moves;
+		value = other.value;
+		return *this;
+	}
+
+	int value;
+};
+
+}  // namespace
+
+template<>
+struct IsTriviallyRelocatable<Relocatable> : std::true_type {
+};
+
+namespace {
+
+class VectorTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		Tracked::Reset();
+		TrackedThrowingMove::Reset();
+	}
+
+	void TearDown() override {
+		EXPECT_EQ(Tracked::alive, 0);
+		EXPECT_EQ(TrackedThrowingMove::alive, 0);
+	}
+};
+
+template<typename T>
+Vector<T> Iota(int count) {
+	Vector<T> v;
+	for (int i = 0; i < count; ++i) {
+		v.EmplaceBack(i);
+	}
+	return v;
+}
+
+// Аллокаторы
+
+TEST_F(VectorTest, CopyConstructionKeepsAllocator) {
+	using Alloc = TaggedAllocator<int>;
+	Vector<int, Alloc> v(Alloc(7));
+	v.PushBack(1);
+	Vector<int, Alloc> copy(v);
+	EXPECT_EQ(copy.GetAllocator().Id(), 7);
+	EXPECT_EQ(copy[0], 1);
+}
+
+TEST_F(VectorTest, MoveAssignmentWithUnequalAllocatorsMovesElements) {
+	using Alloc = TaggedAllocator<Tracked>;
+	{
+		Vector<Tracked, Alloc> source(Alloc(1));
+		Vector<Tracked, Alloc> target(Alloc(2));
+		for (int i = 0; i < 5; ++i) {
+			source.EmplaceBack(i);
+		}
+		target.EmplaceBack(100);
+		target = std::move(source);
+		EXPECT_EQ(target.GetAllocator().Id(), 2);
+		EXPECT_EQ(ValuesOf(target), (std::vector<int> {0, 1, 2, 3, 4}));
+		EXPECT_EQ(Tracked::copies, 0);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+TEST_F(VectorTest, MoveAssignmentWithPropagatingAllocatorStealsBuffer) {
+	using Alloc = TaggedAllocator<int, true>;
+	Vector<int, Alloc> source(Alloc(1));
+	Vector<int, Alloc> target(Alloc(2));
+	source.PushBack(5);
+	target.PushBack(6);
+	const int *buffer = source.Data();
+	target = std::move(source);
+	EXPECT_EQ(target.GetAllocator().Id(), 1);
+	EXPECT_EQ(target.Data(), buffer);
+	EXPECT_EQ(target.Size(), 1u);
+	EXPECT_EQ(source.Size(), 0u);
+}
+
+TEST_F(VectorTest, CopyAndSwapPropagateAllocator) {
+	using Alloc = TaggedAllocator<int, true>;
+	{
+		Vector<int, Alloc> a(Alloc(1));
+		Vector<int, Alloc> b(Alloc(2));
+		a.PushBack(1);
+		b.PushBack(2);
+		b.PushBack(3);
+		a.Swap(b);
+		EXPECT_EQ(a.GetAllocator().Id(), 2);
+		EXPECT_EQ(b.GetAllocator().Id(), 1);
+		EXPECT_EQ(a.Size(), 2u);
+		b = a;
+		EXPECT_EQ(b.GetAllocator().Id(), 2);
+		EXPECT_EQ(b[1], 3);
+	}
+	EXPECT_EQ(Alloc::LiveBlocks(), 0u);
+}
+
+// Тривиально перемещаемые элементы
+
+TEST_F(VectorTest, GrowthRelocatesTriviallyRelocatableWithoutMoves) {
+	Vector<Relocatable> v;
+	for (int i = 0; i < 100; ++i) {
+		v.EmplaceBack(i);
+	}
+	Relocatable::moves = 0;
+	v.Reserve(1000);
+	v.Emplace(v.begin(), -1);
+	EXPECT_EQ(Relocatable::moves, 0);
+	EXPECT_EQ(v[0].value, -1);
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_EQ(v[i + 1].value, i);
+	}
+}
+
+TEST_F(VectorTest, UniquePtrSurvivesGrowth) {
+	Vector<std::unique_ptr<int>> v;
+	for (int i = 0; i < 50; ++i) {
+		v.PushBack(std::make_unique<int>(i));
+	}
+	for (int i = 0; i < 50; ++i) {
+		EXPECT_EQ(*v[i], i);
+	}
+}
+
+// Рост на месте через reallocate
+
+TEST_F(VectorTest, MallocAllocatorGrowthPreservesElements) {
+	Vector<int, MallocAllocator<int>> numbers;
+	Vector<std::string, MallocAllocator<std::string>> strings;
+	for (int i = 0; i < 10000; ++i) {
+		numbers.PushBack(i);
+		if (i < 500) {
+			strings.PushBack(std::string(40, char('a' + i % 26)));
+		}
+	}
+	for (int i = 0; i < 10000; ++i) {
+		ASSERT_EQ(numbers[i], i);
+	}
+	for (int i = 0; i < 500; ++i) {
+		ASSERT_EQ(strings[i], std::string(40, char('a' + i % 26)));
+	}
+	numbers.ShrinkToFit();
+	// Ёмкость учитывает фактический размер блока malloc
+	EXPECT_GE(numbers.Capacity(), numbers.Size());
+	EXPECT_LT(numbers.Capacity(), numbers.Size() + 16);
+	EXPECT_EQ(numbers[9999], 9999);
+}
+
+// Политики роста
+
+TEST_F(VectorTest, GrowthPolicyControlsCapacity) {
+	Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+	size_t capacity = 0;
+	for (int i = 0; i < 100; ++i) {
+		v.PushBack(i);
+		if (v.Capacity() != capacity) {
+			EXPECT_EQ(v.Capacity(), OneAndHalfGrowth::NextCapacity(capacity, v.Size(), sizeof(int)));
+			capacity = v.Capacity();
+		}
+	}
+
+	Vector<int, std::allocator<int>, MinCapacityGrowth<32>> min;
+	min.PushBack(1);
+	EXPECT_EQ(min.Capacity(), 32u);
+}
+
+// Вставка диапазонов
+
+TEST_F(VectorTest, AppendForwardRangeAllocatesOnce) {
+	std::list<int> items(100);
+	std::iota(items.begin(), items.end(), 0);
+	Vector<int> v;
+	v.PushBack(-1);
+	v.Append(items.begin(), items.end());
+	EXPECT_EQ(v.Size(), 101u);
+	EXPECT_EQ(v.Capacity(), 101u);
+	EXPECT_EQ(v[100], 99);
+}
+
+TEST_F(VectorTest, InsertInputRangeInTheMiddle) {
+	std::istringstream in("7 8 9");
+	Vector<int> v {1, 2, 3};
+	v.Insert(v.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+	EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int> {1, 7, 8, 9, 2, 3}));
+}
+
+TEST_F(VectorTest, InsertCountAndInitializerList) {
+	Vector<int> v {1, 2};
+	v.Insert(v.begin() + 1, 3, 5);
+	v.Insert(v.end(), {8, 9});
+	EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int> {1, 5, 5, 5, 2, 8, 9}));
+	// value — элемент самого вектора
+	v.Insert(v.begin(), 2, v[6]);
+	EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int> {9, 9, 1, 5, 5, 5, 2, 8, 9}));
+}
+
+TEST_F(VectorTest, InsertRangeKeepsVectorWhenCopyThrows) {
+	Vector<Tracked> v = Iota<Tracked>(4);
+	v.Reserve(16);
+	std::vector<Tracked> items {10, 11, 12};
+	Tracked::copies_until_throw = 2;
+	EXPECT_THROW(v.Insert(v.begin() + 1, items.begin(), items.end()), std::runtime_error);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 2, 3}));
+
+	Tracked::copies_until_throw = 1;
+	EXPECT_THROW(v.Insert(v.begin(), items.begin(), items.end()), std::runtime_error);
+	Tracked::copies_until_throw = -1;
+	v.ShrinkToFit();
+	Tracked::copies_until_throw = 1;
+	EXPECT_THROW(v.Insert(v.begin() + 2, items.begin(), items.end()), std::runtime_error);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 2, 3}));
+	EXPECT_EQ(v.Capacity(), 4u);
+}
+
+// Удаление диапазонов
+
+TEST_F(VectorTest, EraseRangeAndEraseIf) {
+	Vector<Tracked> v = Iota<Tracked>(10);
+	auto it = v.Erase(v.begin() + 2, v.begin() + 5);
+	EXPECT_EQ(it->value, 5);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 5, 6, 7, 8, 9}));
+	EXPECT_EQ(Tracked::alive, 7);
+
+	EXPECT_EQ(v.EraseIf([](const Tracked &item) {
+		return item.value % 2 != 0;
+	}), 4u);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 6, 8}));
+
+	v.SwapErase(v.begin());
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {8, 6}));
+	v.SwapErase(v.begin() + 1);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {8}));
+	EXPECT_EQ(Tracked::alive, 1);
+	v.Erase(v.begin(), v.begin());
+	EXPECT_EQ(v.Size(), 1u);
+}
+
+// Неинициализированный рост
+
+TEST_F(VectorTest, DefaultInitResize) {
+	Vector<int> v(1000, kDefaultInit);
+	EXPECT_EQ(v.Size(), 1000u);
+	v.ResizeUninitialized(2000);
+	for (size_t i = 0; i < v.Size(); ++i) {
+		v[i] = int(i);
+	}
+	EXPECT_EQ(v[1999], 1999);
+	v.ResizeDefaultInit(10);
+	EXPECT_EQ(v.Size(), 10u);
+
+	Vector<Tracked> tracked;
+	tracked.ResizeDefaultInit(3);
+	EXPECT_EQ(ValuesOf(tracked), (std::vector<int> {0, 0, 0}));
+}
+
+// Инструментирование
+
+struct InstrumentedTag {
+	static constexpr const char *kName = "vector_test";
+};
+
+TEST_F(VectorTest, InstrumentationCountsAllocationsAndRelocations) {
+	VectorStats &stats = CountingInstrumentation<InstrumentedTag>::Stats();
+	const uint64_t allocations = stats.allocations;
+	const uint64_t reallocations = stats.reallocations;
+	{
+		InstrumentedVector<int, InstrumentedTag> v;
+		for (int i = 0; i < 8; ++i) {
+			v.PushBack(i);
+		}
+	}
+	// Ёмкости 1, 2, 4, 8: четыре выделения, из них три — перенос старого буфера
+	EXPECT_EQ(stats.allocations - allocations, 4u);
+	EXPECT_EQ(stats.reallocations - reallocations, 3u);
+	EXPECT_GE(stats.relocated_elements, 1u + 2u + 4u);
+	EXPECT_GE(stats.peak_size, 8u);
+	EXPECT_GE(stats.peak_capacity, 8u);
+
+	bool registered = false;
+	VectorStatsRegistry::Instance().ForEach([&registered](const VectorStats &item) {
+		registered = registered || std::string(item.name) == "vector_test";
+	});
+	EXPECT_TRUE(registered);
+}
+
+struct ReserveTag {
+	static constexpr const char *kName = "vector_test_reserve";
+};
+
+TEST_F(VectorTest, InstrumentationRecordsCapacityOfReserve) {
+	static_assert(noexcept(CountingInstrumentation<ReserveTag>::Stats()));
+	VectorStats &stats = CountingInstrumentation<ReserveTag>::Stats();
+	InstrumentedVector<int, ReserveTag> v;
+	v.Reserve(1000);
+	EXPECT_EQ(stats.peak_capacity, 1000u);
+	EXPECT_EQ(stats.peak_size, 0u);
+	v.PushBack(1);
+	v.Trim(1);
+	EXPECT_EQ(v.Capacity(), 1u);
+	EXPECT_EQ(stats.peak_capacity, 1000u);
+	EXPECT_EQ(stats.allocations, 2u);
+}
+
+// Параллельные операции
+
+TEST_F(VectorTest, ParallelOperationsMatchSequential) {
+	const size_t size = 3 * kParallelMinBytesPerThread / sizeof(int);
+	Vector<int> v(size, kParallel);
+	EXPECT_EQ(v.Size(), size);
+	EXPECT_EQ(std::count(v.begin(), v.end(), 0), std::ptrdiff_t(size));
+	for (size_t i = 0; i < size; ++i) {
+		v[i] = int(i);
+	}
+	v.Transform([](int x) {
+		return x * 2;
+	}, kParallel);
+	Vector<int> copy(v, kParallel);
+	copy.Reserve(size * 2, kParallel);
+	ASSERT_EQ(copy.Size(), size);
+	for (size_t i = 0; i < size; i += 997) {
+		ASSERT_EQ(copy[i], int(i) * 2);
+	}
+	EXPECT_EQ(copy[size - 1], int(size - 1) * 2);
+}
+
+// Передача буфера
+
+TEST_F(VectorTest, ReleaseAndAdoptKeepBuffer) {
+	Vector<int> source {1, 2, 3};
+	source.Reserve(10);
+	VectorBuffer<int> buffer = source.Release();
+	EXPECT_EQ(source.Size(), 0u);
+	EXPECT_EQ(source.Capacity(), 0u);
+	EXPECT_EQ(buffer.size, 3u);
+	EXPECT_EQ(buffer.capacity, 10u);
+
+	Vector<int> target;
+	target.Adopt(buffer.data, buffer.size, buffer.capacity);
+	EXPECT_EQ(target.Data(), buffer.data);
+	EXPECT_EQ(target.Capacity(), 10u);
+	EXPECT_EQ(std::vector<int>(target.begin(), target.end()), (std::vector<int> {1, 2, 3}));
+}
+
+TEST_F(VectorTest, AdoptForeignBufferCallsDeleterOnce) {
+	static int deleted = 0;
+	deleted = 0;
+	{
+		int *buffer = static_cast<int*>(std::malloc(4 * sizeof(int)));
+		buffer[0] = 4;
+		buffer[1] = 5;
+		AdoptingVector<int> v;
+		v.Adopt(buffer, 2, 4, [](int *p, size_t capacity) {
+			EXPECT_EQ(capacity, 4u);
+			++deleted;
+			std::free(p);
+		});
+		EXPECT_EQ(v.Data(), buffer);
+		v.PushBack(6);
+		v.PushBack(7);
+		EXPECT_EQ(deleted, 0);
+		// Рост переносит элементы в буфер std::allocator и возвращает чужой буфер его владельцу
+		v.PushBack(8);
+		EXPECT_EQ(deleted, 1);
+		EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int> {4, 5, 6, 7, 8}));
+	}
+	EXPECT_EQ(deleted, 1);
+}
+
+TEST_F(VectorTest, StdVectorConversions) {
+	std::vector<int> items {1, 2, 3};
+	const int *data = items.data();
+	auto adopted = AdoptStdVector(std::move(items));
+	EXPECT_EQ(adopted.Data(), data);
+	EXPECT_EQ(adopted.Size(), 3u);
+
+	std::vector<std::string> strings {"a", "b"};
+	Vector<std::string> v = FromStdVector(std::move(strings));
+	EXPECT_TRUE(strings.empty());
+	v.PushBack("c");
+	std::vector<std::string> back = ToStdVector(std::move(v));
+	EXPECT_EQ(back, (std::vector<std::string> {"a", "b", "c"}));
+	EXPECT_EQ(v.Size(), 0u);
+}
+
+// Уменьшение ёмкости
+
+TEST_F(VectorTest, TrimAndShrinkToFit) {
+	Vector<Tracked> v = Iota<Tracked>(5);
+	v.Reserve(100);
+	v.Trim(50);
+	EXPECT_EQ(v.Capacity(), 50u);
+	v.Trim(2);
+	EXPECT_EQ(v.Capacity(), 5u);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 2, 3, 4}));
+	v.Clear();
+	EXPECT_EQ(v.Capacity(), 5u);
+	v.ShrinkToFit();
+	EXPECT_EQ(v.Capacity(), 0u);
+	EXPECT_EQ(v.Data(), nullptr);
+}
+
+// Вставка без временного объекта
+
+TEST_F(VectorTest, EmplaceConstructsInPlace) {
+	Vector<Tracked> v = Iota<Tracked>(4);
+	v.Reserve(8);
+	Tracked::moves = 0;
+	v.Emplace(v.begin() + 1, 42);
+	// Перемещаются только три сдвинутых элемента
+	EXPECT_EQ(Tracked::moves, 3);
+	EXPECT_EQ(Tracked::copies, 0);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 42, 1, 2, 3}));
+}
+
+TEST_F(VectorTest, EmplaceCopyOfOwnElement) {
+	Vector<std::string> v;
+	v.Reserve(8);
+	for (int i = 0; i < 4; ++i) {
+		v.PushBack(std::string(32, char('a' + i)));
+	}
+	v.Emplace(v.begin(), v[2]);
+	v.Insert(v.begin() + 2, v[4]);
+	EXPECT_EQ(v[0], std::string(32, 'c'));
+	EXPECT_EQ(v[2], std::string(32, 'd'));
+	v.ShrinkToFit();
+	v.Emplace(v.begin(), v[5]);
+	EXPECT_EQ(v[0], std::string(32, 'd'));
+	EXPECT_EQ(v.Size(), 7u);
+}
+
+TEST_F(VectorTest, EmplaceKeepsVectorWhenCopyThrows) {
+	Vector<Tracked> v = Iota<Tracked>(4);
+	v.Reserve(8);
+	const Tracked item(9);
+	Tracked::copies_until_throw = 0;
+	EXPECT_THROW(v.Emplace(v.begin() + 1, item), std::runtime_error);
+	EXPECT_THROW(v.Emplace(v.begin(), v[3]), std::runtime_error);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 2, 3}));
+}
+
+// Единый путь перераспределения
+
+TEST_F(VectorTest, GrowthKeepsVectorWhenCopyThrows) {
+	Vector<TrackedThrowingMove> v;
+	for (int i = 0; i < 4; ++i) {
+		v.EmplaceBack(i);
+	}
+	v.ShrinkToFit();
+	const TrackedThrowingMove *data = v.Data();
+	// Перемещение может бросить, поэтому при росте элементы копируются; третья копия бросает
+	TrackedThrowingMove::copies_until_throw = 2;
+	EXPECT_THROW(v.EmplaceBack(4), std::runtime_error);
+	EXPECT_EQ(v.Data(), data);
+	EXPECT_EQ(v.Capacity(), 4u);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 2, 3}));
+	EXPECT_EQ(TrackedThrowingMove::moves, 0);
+
+	TrackedThrowingMove::copies_until_throw = -1;
+	v.Emplace(v.begin() + 2, 10);
+	EXPECT_EQ(ValuesOf(v), (std::vector<int> {0, 1, 10, 2, 3}));
+}
+
+// Отладочный режим
+
+#if !VECTOR_HARDENED
+// Без VECTOR_HARDENED вектор не хранит ничего сверх буфера, а итераторы — обычные указатели
+static_assert(sizeof(Vector<int>) == 3 * sizeof(void*));
+static_assert(std::is_same_v<Vector<int>::iterator, int*>);
+#endif
+
+}  // namespace
@@ -0,0 +1,379 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Буфер, в начале которого хранится заголовок с размером и ёмкостью. Сам объект — аллокатор
+// и один указатель на заголовок, у пустого буфера нулевой. SizeType задаёт тип полей заголовка:
+// uint32_t уменьшает заголовок до 8 байт, но ограничивает ёмкость 2^32 - 1 элементами
+template<typename T, typename Allocator = std::allocator<T>, typename SizeType = size_t>
+class ThinMemory {
+	static_assert(std::is_unsigned_v<SizeType>, "SizeType must be an unsigned integer type");
+
+	struct Header {
+		SizeType size;
+		SizeType capacity;
+	};
+
+	// Блок выделяется единицами Unit, выровненными и под заголовок, и под элементы
+	static constexpr size_t kAlign = std::max(alignof(Header), alignof(T));
+
+	struct alignas(kAlign) Unit {
+		unsigned char bytes[kAlign];
+	};
+
+	static constexpr size_t kHeaderUnits = (sizeof(Header) + kAlign - 1) / kAlign;
+
+	using UnitAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Unit>;
+	using UnitTraits = std::allocator_traits<UnitAllocator>;
+
+public:
+	using allocator_type = Allocator;
+
+	ThinMemory() = default;
+
+	explicit ThinMemory(const Allocator &alloc) noexcept :
+			alloc_(alloc) {
+	}
+
+	ThinMemory(size_t capacity, const Allocator &alloc) :
+			alloc_(alloc), header_(Allocate(capacity)) {
+	}
+
+	ThinMemory(const ThinMemory&) = delete;
+	ThinMemory& operator=(const ThinMemory&) = delete;
+
+	ThinMemory(ThinMemory &&other) noexcept :
+			alloc_(std::move(other.alloc_)), header_(std::exchange(other.header_, nullptr)) {
+	}
+
+	ThinMemory& operator=(ThinMemory &&rhs) noexcept {
+		if (this != &rhs) {
+			Deallocate(header_);
+			alloc_ = std::move(rhs.alloc_);
+			header_ = std::exchange(rhs.header_, nullptr);
+		}
+		return *this;
+	}
+
+	~ThinMemory() {
+		Deallocate(header_);
+	}
+
+	T* GetAddress() noexcept {
+		return header_ != nullptr ? reinterpret_cast<T*>(reinterpret_cast<Unit*>(header_) + kHeaderUnits) : nullptr;
+	}
+
+	const T* GetAddress() const noexcept {
+		return const_cast<ThinMemory&>(*this).GetAddress();
+	}
+
+	size_t Capacity() const noexcept {
+		return header_ != nullptr ? header_->capacity : 0;
+	}
+
+	// Число созданных элементов, которое владелец хранит в заголовке
+	size_t Size() const noexcept {
+		return header_ != nullptr ? header_->size : 0;
+	}
+
+	void SetSize(size_t size) noexcept {
+		assert(size <= Capacity());
+		if (header_ != nullptr) {
+			header_->size = static_cast<SizeType>(size);
+		}
+	}
+
+	void Swap(ThinMemory &other) noexcept {
+		using std::swap;
+		swap(alloc_, other.alloc_);
+		SwapBuffers(other);
+	}
+
+	// Обменивает только буферы, аллокаторы остаются на месте (они должны быть равны)
+	void SwapBuffers(ThinMemory &other) noexcept {
+		std::swap(header_, other.header_);
+	}
+
+	const Allocator& GetAllocator() const noexcept {
+		return alloc_;
+	}
+
+private:
+	static size_t UnitCount(size_t capacity) noexcept {
+		return kHeaderUnits + (capacity * sizeof(T) + kAlign - 1) / kAlign;
+	}
+
+	Header* Allocate(size_t capacity) {
+		if (capacity == 0) {
+			return nullptr;
+		}
+		if (capacity > std::numeric_limits<SizeType>::max()) {
+			throw std::length_error("ThinMemory capacity does not fit SizeType");
+		}
+		UnitAllocator units(alloc_);
+		Unit *block = UnitTraits::allocate(units, UnitCount(capacity));
+		return new (static_cast<void*>(block)) Header{0, static_cast<SizeType>(capacity)};
+	}
+
+	void Deallocate(Header *header) noexcept {
+		if (header != nullptr) {
+			UnitAllocator units(alloc_);
+			UnitTraits::deallocate(units, reinterpret_cast<Unit*>(header), UnitCount(header->capacity));
+		}
+	}
+
+	[[no_unique_address]] Allocator alloc_;
+	Header *header_ = nullptr;
+};
+
+// Вектор размером в один указатель: размер и ёмкость хранятся в заголовке ThinMemory перед элементами,
+// поэтому пустой вектор не выделяет памяти и занимает 8 байт вместо 24 у Vector. Подходит для больших
+// массивов вложенных векторов, которые в основном пусты. Цена — лишнее обращение к памяти при чтении
+// Size() и Capacity()
+template<typename T, typename Allocator = std::allocator<T>, typename SizeType = size_t,
+		typename GrowthPolicy = DoublingGrowth>
+class ThinVector {
+	using AllocTraits = std::allocator_traits<Allocator>;
+public:
+	using iterator = T*;
+	using const_iterator = const T*;
+	using allocator_type = Allocator;
+
+	ThinVector() = default;
+
+	explicit ThinVector(const Allocator &alloc) noexcept :
+			data_(alloc) {
+	}
+
+	explicit ThinVector(size_t size, const Allocator &alloc = Allocator()) :
+			data_(size, alloc) {
+		std::uninitialized_value_construct_n(begin(), size);
+		data_.SetSize(size);
+	}
+
+	ThinVector(std::initializer_list<T> items, const Allocator &alloc = Allocator()) :
+			data_(items.size(), alloc) {
+		std::uninitialized_copy_n(items.begin(), items.size(), begin());
+		data_.SetSize(items.size());
+	}
+
+	ThinVector(const ThinVector &other) :
+			data_(other.Size(), AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+		std::uninitialized_copy_n(other.begin(), other.Size(), begin());
+		data_.SetSize(other.Size());
+	}
+
+	ThinVector& operator=(const ThinVector &other) {
+		if (this != &other) {
+			AssignFrom(other.begin(), other.Size());
+		}
+		return *this;
+	}
+
+	ThinVector(ThinVector &&other) noexcept :
+			data_(std::move(other.data_)) {
+	}
+
+	ThinVector& operator=(ThinVector &&other) {
+		if (this != &other) {
+			if (GetAllocator() != other.GetAllocator()) {
+				AssignFrom(std::make_move_iterator(other.begin()), other.Size());
+				other.Clear();
+			} else {
+				// Забираем буфер other, а свой старый буфер отдаём временному объекту на освобождение
+				Clear();
+				ThinMemory<T, Allocator, SizeType> old_data(GetAllocator());
+				old_data.SwapBuffers(data_);
+				data_.SwapBuffers(other.data_);
+			}
+		}
+		return *this;
+	}
+
+	~ThinVector() {
+		std::destroy_n(begin(), Size());
+	}
+
+	void Swap(ThinVector &other) noexcept {
+		if constexpr (AllocTraits::propagate_on_container_swap::value) {
+			data_.Swap(other.data_);
+		} else {
+			assert(GetAllocator() == other.GetAllocator());
+			data_.SwapBuffers(other.data_);
+		}
+	}
+
+	void Reserve(size_t new_capacity) {
+		if (new_capacity > Capacity()) {
+			Reallocate(new_capacity);
+		}
+	}
+
+	// Освобождает неиспользуемую ёмкость; пустой вектор снова становится нулевым указателем
+	void ShrinkToFit() {
+		if (Size() < Capacity()) {
+			Reallocate(Size());
+		}
+	}
+
+	void Clear() noexcept {
+		std::destroy_n(begin(), Size());
+		data_.SetSize(0);
+	}
+
+	void Resize(size_t new_size) {
+		const size_t size = Size();
+		if (new_size < size) {
+			std::destroy_n(begin() + new_size, size - new_size);
+			data_.SetSize(new_size);
+		} else if (new_size > size) {
+			Reserve(new_size);
+			std::uninitialized_value_construct_n(begin() + size, new_size - size);
+			data_.SetSize(new_size);
+		}
+	}
+
+	template<typename M>
+	void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
+	}
+
+	template<typename ... Args>
+	T& EmplaceBack(Args &&... args) {
+		return *Emplace(end(), std::forward<Args>(args)...);
+	}
+
+	template<typename ... Args>
+	iterator Emplace(const_iterator pos, Args &&... args) {
+		const size_t pos_index = pos - begin();
+		const size_t size = Size();
+		if (size == Capacity()) {
+			ThinMemory<T, Allocator, SizeType> new_data(NextCapacity(), GetAllocator());
+			new (new_data.GetAddress() + pos_index) T(std::forward<Args>(args)...);
+			try {
+				UninitializedRelocateAround(begin(), size, pos_index, new_data.GetAddress());
+			} catch (...) {
+				std::destroy_at(new_data.GetAddress() + pos_index);
+				throw;
+			}
+			data_.SwapBuffers(new_data);
+		} else if (pos_index == size) {
+			new (end()) T(std::forward<Args>(args)...);
+		} else {
+			vector_detail::EmplaceInGap(begin(), size, pos_index, std::forward<Args>(args)...);
+		}
+		data_.SetSize(size + 1);
+		return begin() + pos_index;
+	}
+
+	iterator Insert(const_iterator pos, const T &item) {
+		return Emplace(pos, item);
+	}
+	iterator Insert(const_iterator pos, T &&item) {
+		return Emplace(pos, std::move(item));
+	}
+
+	iterator Erase(const_iterator pos) {
+		const size_t pos_index = pos - begin();
+		vector_detail::EraseRange(begin(), Size(), pos_index, 1);
+		data_.SetSize(Size() - 1);
+		return begin() + pos_index;
+	}
+
+	void PopBack() noexcept {
+		assert(Size() != 0);
+		std::destroy_at(end() - 1);
+		data_.SetSize(Size() - 1);
+	}
+
+	size_t Size() const noexcept {
+		return data_.Size();
+	}
+
+	size_t Capacity() const noexcept {
+		return data_.Capacity();
+	}
+
+	const Allocator& GetAllocator() const noexcept {
+		return data_.GetAllocator();
+	}
+
+	const T& operator[](size_t index) const noexcept {
+		assert(index < Size());
+		return begin()[index];
+	}
+
+	T& operator[](size_t index) noexcept {
+		assert(index < Size());
+		return begin()[index];
+	}
+
+	iterator begin() noexcept {
+		return data_.GetAddress();
+	}
+	iterator end() noexcept {
+		return begin() + Size();
+	}
+	const_iterator begin() const noexcept {
+		return data_.GetAddress();
+	}
+	const_iterator end() const noexcept {
+		return begin() + Size();
+	}
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	// Рост ограничивается наибольшей ёмкостью, представимой в SizeType
+	size_t NextCapacity() const noexcept {
+		return std::max(std::min<size_t>(GrowthPolicy::NextCapacity(Capacity(), Size() + 1, sizeof(T)),
+				std::numeric_limits<SizeType>::max()), Size() + 1);
+	}
+
+	void Reallocate(size_t new_capacity) {
+		const size_t size = Size();
+		ThinMemory<T, Allocator, SizeType> new_data(new_capacity, GetAllocator());
+		UninitializedRelocate(begin(), size, new_data.GetAddress());
+		new_data.SetSize(size);
+		data_.SwapBuffers(new_data);
+	}
+
+	// Присваивает элементы [first, first + count), по возможности переиспользуя уже выделенную память
+	template<typename RandomIt>
+	void AssignFrom(RandomIt first, size_t count) {
+		const size_t size = Size();
+		if (count <= Capacity()) {
+			if (size <= count) {
+				std::copy_n(first, size, begin());
+				std::uninitialized_copy_n(first + size, count - size, begin() + size);
+			} else {
+				std::copy_n(first, count, begin());
+				std::destroy_n(begin() + count, size - count);
+			}
+			data_.SetSize(count);
+		} else {
+			ThinMemory<T, Allocator, SizeType> new_data(count, GetAllocator());
+			std::uninitialized_copy_n(first, count, new_data.GetAddress());
+			new_data.SetSize(count);
+			Clear();
+			data_.SwapBuffers(new_data);
+		}
+	}
+
+	ThinMemory<T, Allocator, SizeType> data_;
+};
@@ -1,298 +1,1676 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cassert>
+#include <cstring>
 #include <cstdlib>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <new>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <memory>
+#include <type_traits>
 
+// Признак того, что объект типа T можно перенести в другое место памяти побайтовым копированием,
+// не вызывая конструктор перемещения и деструктор исходного объекта.
+// Для собственных типов-дескрипторов (владеющих указателем и т.п.) шаблон можно специализировать
 template<typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {
+};
+
+template<typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {
+};
+
+template<typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Стратегии роста ёмкости. NextCapacity получает текущую ёмкость, требуемое число элементов и размер
+// элемента и возвращает новую ёмкость не меньше required
+
+// Удвоение ёмкости
+struct DoublingGrowth {
+	static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t) noexcept {
+		return std::max(capacity == 0 ? 1 : capacity * 2, required);
+	}
+};
+
+// Рост в полтора раза: освобождённые ранее блоки со временем снова подходят под новый буфер
+struct OneAndHalfGrowth {
+	static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t) noexcept {
+		return std::max(capacity + capacity / 2 + 1, required);
+	}
+};
+
+// Не даёт ёмкости быть меньше MinElements, дальше растёт по правилу Base
+template<size_t MinElements, typename Base = DoublingGrowth>
+struct MinCapacityGrowth {
+	static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+		return std::max(Base::NextCapacity(capacity, required, element_size), MinElements);
+	}
+};
+
+// Первый буфер занимает не меньше одной кэш-линии
+template<typename Base = DoublingGrowth, size_t CacheLineSize = 64>
+struct CacheLineGrowth {
+	static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+		return std::max(Base::NextCapacity(capacity, required, element_size), (CacheLineSize + element_size - 1) / element_size);
+	}
+};
+
+// Округляет размер буфера в байтах до типичных классов размеров аллокаторов: до степени двойки для мелких
+// блоков и до целого числа страниц для крупных, чтобы хвост блока не простаивал. Фактически доступный
+// размер блока дополнительно учитывается RawMemory, если аллокатор сообщает его через usable_size
+template<typename Base = DoublingGrowth, size_t PageSize = 4096>
+struct SizeClassGrowth {
+	static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+		size_t bytes = Base::NextCapacity(capacity, required, element_size) * element_size;
+		if (bytes < PageSize) {
+			size_t size_class = 16;
+			while (size_class < bytes) {
+				size_class *= 2;
+			}
+			bytes = size_class;
+		} else {
+			bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+		}
+		return bytes / element_size;
+	}
+};
+
+// Признак того, что аллокатор умеет изменять размер уже выделенного блока:
+// T* reallocate(T *p, size_t old_n, size_t new_n). Содержимое блока при этом переносится побайтово
+template<typename Allocator, typename = void>
+struct HasReallocate : std::false_type {
+};
+
+template<typename Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+		std::declval<typename Allocator::value_type*>(), size_t(), size_t()))>> : std::true_type {
+};
+
+// Варианты std::uninitialized_*, пригодные для константных вычислений: алгоритмы стандартной библиотеки
+// в C++20 не constexpr, поэтому там элементы создаются по одному через std::construct_at
+template<typename InputIt, typename T>
+constexpr void UninitializedCopyN(InputIt first, size_t count, T *to) {
+	if (std::is_constant_evaluated()) {
+		size_t done = 0;
+		try {
+			for (; done != count; ++done, ++first) {
+				std::construct_at(to + done, *first);
+			}
+		} catch (...) {
+			std::destroy_n(to, done);
+			throw;
+		}
+	} else {
+		std::uninitialized_copy_n(first, count, to);
+	}
+}
+
+template<typename T>
+constexpr void UninitializedMoveN(T *from, size_t count, T *to) {
+	UninitializedCopyN(std::make_move_iterator(from), count, to);
+}
+
+template<typename T>
+constexpr void UninitializedValueConstructN(T *to, size_t count) {
+	if (std::is_constant_evaluated()) {
+		size_t done = 0;
+		try {
+			for (; done != count; ++done) {
+				std::construct_at(to + done);
+			}
+		} catch (...) {
+			std::destroy_n(to, done);
+			throw;
+		}
+	} else {
+		std::uninitialized_value_construct_n(to, count);
+	}
+}
+
+// В константных вычислениях неинициализированные значения недопустимы, поэтому там элементы
+// инициализируются значением
+template<typename T>
+constexpr void UninitializedDefaultConstructN(T *to, size_t count) {
+	if (std::is_constant_evaluated()) {
+		UninitializedValueConstructN(to, count);
+	} else {
+		std::uninitialized_default_construct_n(to, count);
+	}
+}
+
+// Переносит count элементов из from в неинициализированную память to, оставляя в to gap_size свободных
+// ячеек начиная с индекса gap. Исходные элементы перестают существовать, а если перенос бросил исключение,
+// остаются нетронутыми
+template<typename T>
+constexpr void UninitializedRelocateAround(T *from, size_t count, size_t gap, T *to, size_t gap_size = 1) {
+	if constexpr (IsTriviallyRelocatableV<T>) {
+		if (!std::is_constant_evaluated()) {
+			if (gap != 0) {
+				std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), gap * sizeof(T));
+			}
+			if (gap != count) {
+				std::memcpy(static_cast<void*>(to + gap + gap_size), static_cast<const void*>(from + gap), (count - gap) * sizeof(T));
+			}
+			return;
+		}
+	}
+	if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+		UninitializedMoveN(from, gap, to);
+		UninitializedMoveN(from + gap, count - gap, to + gap + gap_size);
+	} else {
+		UninitializedCopyN(from, gap, to);
+		try {
+			UninitializedCopyN(from + gap, count - gap, to + gap + gap_size);
+		} catch (...) {
+			std::destroy_n(to, gap);
+			throw;
+		}
+	}
+	std::destroy_n(from, count);
+}
+
+// Переносит count элементов из from в неинициализированную память to без свободной ячейки
+template<typename T>
+constexpr void UninitializedRelocate(T *from, size_t count, T *to) {
+	UninitializedRelocateAround(from, count, count, to, 0);
+}
+
+// Общие для Vector и векторов со встроенным или внешним буфером (SmallVector, StaticVector, ThinVector)
+// операции над массивом data из size элементов, за которым есть свободные ячейки. Для Devector есть
+// зеркальные операции над массивом со свободными ячейками перед ним
+namespace vector_detail {
+
+// Перенос элементов внутри буфера не бросает исключений, поэтому вставку без перераспределения
+// можно откатить
+template<typename T>
+inline constexpr bool kNothrowRelocate = IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>;
+
+// Сдвигает элементы [pos_index, size) на count ячеек вправо, оставляя ячейки [pos_index, pos_index + count)
+// неинициализированными. Свободных ячеек за size должно хватать
+template<typename T>
+constexpr void OpenGap(T *data, size_t size, size_t pos_index, size_t count) noexcept {
+	static_assert(kNothrowRelocate<T>);
+	T *dest = data + pos_index;
+	const size_t tail = size - pos_index;
+	if constexpr (IsTriviallyRelocatableV<T>) {
+		if (!std::is_constant_evaluated()) {
+			std::memmove(static_cast<void*>(dest + count), static_cast<const void*>(dest), tail * sizeof(T));
+			return;
+		}
+	}
+	for (size_t i = tail; i-- != 0;) {
+		std::construct_at(dest + count + i, std::move(dest[i]));
+		std::destroy_at(dest + i);
+	}
+}
+
+// Отменяет OpenGap(data, size, pos_index, count): ячейки разрыва снова должны быть неинициализированными
+template<typename T>
+constexpr void CloseGap(T *data, size_t size, size_t pos_index, size_t count) noexcept {
+	static_assert(kNothrowRelocate<T>);
+	T *dest = data + pos_index;
+	const size_t tail = size - pos_index;
+	if constexpr (IsTriviallyRelocatableV<T>) {
+		if (!std::is_constant_evaluated()) {
+			std::memmove(static_cast<void*>(dest), static_cast<const void*>(dest + count), tail * sizeof(T));
+			return;
+		}
+	}
+	for (size_t i = 0; i != tail; ++i) {
+		std::construct_at(dest + i, std::move(dest[count + i]));
+		std::destroy_at(dest + count + i);
+	}
+}
+
+// Зеркальный OpenGap для массива со свободными ячейками перед data (Devector): сдвигает элементы
+// [0, pos_index) на count ячеек влево, оставляя ячейки [pos_index - count, pos_index) неинициализированными
+template<typename T>
+constexpr void OpenFrontGap(T *data, size_t pos_index, size_t count) noexcept {
+	static_assert(kNothrowRelocate<T>);
+	if constexpr (IsTriviallyRelocatableV<T>) {
+		if (!std::is_constant_evaluated()) {
+			std::memmove(static_cast<void*>(data - count), static_cast<const void*>(data), pos_index * sizeof(T));
+			return;
+		}
+	}
+	for (size_t i = 0; i != pos_index; ++i) {
+		std::construct_at(data - count + i, std::move(data[i]));
+		std::destroy_at(data + i);
+	}
+}
+
+// Отменяет OpenFrontGap(data, pos_index, count)
+template<typename T>
+constexpr void CloseFrontGap(T *data, size_t pos_index, size_t count) noexcept {
+	static_assert(kNothrowRelocate<T>);
+	if constexpr (IsTriviallyRelocatableV<T>) {
+		if (!std::is_constant_evaluated()) {
+			std::memmove(static_cast<void*>(data), static_cast<const void*>(data - count), pos_index * sizeof(T));
+			return;
+		}
+	}
+	for (size_t i = pos_index; i-- != 0;) {
+		std::construct_at(data + i, std::move(data[i - count]));
+		std::destroy_at(data + i - count);
+	}
+}
+
+template<typename T>
+constexpr bool Contains(const T *data, size_t size, const void *address) noexcept {
+	const std::less<const void*> less;
+	return !less(address, data) && less(address, data + size);
+}
+
+// Могут ли аргументы ссылаться на элементы массива. Для аргументов типа T и скалярных это проверяется
+// по адресу; аргументы других типов (указатели, string_view и т.п.) могут ссылаться на элементы косвенно
+template<typename T, typename ... Args>
+constexpr bool MayAlias(const T *data, size_t size, const Args &... args) noexcept {
+	// Адреса разных объектов нельзя сравнивать в константных вычислениях
+	if (std::is_constant_evaluated()) {
+		return true;
+	}
+	if constexpr (((std::is_same_v<Args, T> || std::is_arithmetic_v<Args> || std::is_enum_v<Args>) && ...)) {
+		return (Contains(data, size, std::addressof(args)) || ...);
+	} else {
+		return true;
+	}
+}
+
+// Создаёт элемент в ячейке pos_index < size, сдвигая хвост в свободную ячейку data[size]. Если аргументы
+// не ссылаются на элементы, элемент создаётся прямо в освобождённой ячейке, иначе — заранее, до сдвига хвоста.
+// Если перенос элементов не бросает, при исключении массив не меняется; иначе сдвиг идёт перемещающим
+// присваиванием, и при исключении в нём элементы остаются в согласованном, но неопределённом состоянии
+template<typename T, typename ... Args>
+constexpr void EmplaceInGap(T *data, size_t size, size_t pos_index, Args &&... args) {
+	T *dest = data + pos_index;
+	if constexpr (kNothrowRelocate<T>) {
+		if (!MayAlias(data, size, args...)) {
+			OpenGap(data, size, pos_index, 1);
+			try {
+				std::construct_at(dest, std::forward<Args>(args)...);
+			} catch (...) {
+				CloseGap(data, size, pos_index, 1);
+				throw;
+			}
+		} else {
+			if constexpr (IsTriviallyRelocatableV<T>) {
+				if (!std::is_constant_evaluated()) {
+					alignas(T) unsigned char slot[sizeof(T)];
+					T *item = new (slot) T(std::forward<Args>(args)...);
+					OpenGap(data, size, pos_index, 1);
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(item), sizeof(T));
+					return;
+				}
+			}
+			T temp(std::forward<Args>(args)...);
+			OpenGap(data, size, pos_index, 1);
+			std::construct_at(dest, std::move(temp));
+		}
+	} else {
+		T temp(std::forward<Args>(args)...);
+		T *last = data + size;
+		std::construct_at(last, std::move(last[-1]));
+		try {
+			std::move_backward(dest, last - 1, last);
+			*dest = std::move(temp);
+		} catch (...) {
+			std::destroy_at(last);
+			throw;
+		}
+	}
+}
+
+// Зеркальный EmplaceInGap: создаёт элемент перед ячейкой 0 < pos_index <= size, сдвигая элементы [0, pos_index)
+// в свободную ячейку data[-1]. После вызова массив начинается с data - 1, и новый элемент в нём имеет индекс pos_index
+template<typename T, typename ... Args>
+constexpr void EmplaceInFrontGap(T *data, size_t size, size_t pos_index, Args &&... args) {
+	T *dest = data + pos_index - 1;
+	if constexpr (kNothrowRelocate<T>) {
+		if (!MayAlias(data, size, args...)) {
+			OpenFrontGap(data, pos_index, 1);
+			try {
+				std::construct_at(dest, std::forward<Args>(args)...);
+			} catch (...) {
+				CloseFrontGap(data, pos_index, 1);
+				throw;
+			}
+		} else {
+			if constexpr (IsTriviallyRelocatableV<T>) {
+				if (!std::is_constant_evaluated()) {
+					alignas(T) unsigned char slot[sizeof(T)];
+					T *item = new (slot) T(std::forward<Args>(args)...);
+					OpenFrontGap(data, pos_index, 1);
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(item), sizeof(T));
+					return;
+				}
+			}
+			T temp(std::forward<Args>(args)...);
+			OpenFrontGap(data, pos_index, 1);
+			std::construct_at(dest, std::move(temp));
+		}
+	} else {
+		T temp(std::forward<Args>(args)...);
+		T *first = data - 1;
+		std::construct_at(first, std::move(data[0]));
+		try {
+			std::move(data + 1, data + pos_index, data);
+			*dest = std::move(temp);
+		} catch (...) {
+			std::destroy_at(first);
+			throw;
+		}
+	}
+}
+
+// Удаляет элементы [first_index, first_index + count), сдвигая хвост за один проход.
+// Ячейки [size - count, size) после этого не инициализированы
+template<typename T>
+constexpr void EraseRange(T *data, size_t size, size_t first_index, size_t count) {
+	T *dest = data + first_index;
+	if constexpr (IsTriviallyRelocatableV<T>) {
+		if (!std::is_constant_evaluated()) {
+			std::destroy_n(dest, count);
+			std::memmove(static_cast<void*>(dest), static_cast<const void*>(dest + count), (size - first_index - count) * sizeof(T));
+			return;
+		}
+	}
+	std::move(dest + count, data + size, dest);
+	std::destroy_n(data + size - count, count);
+}
+
+}  // namespace vector_detail
+
+// Медленные пути (перераспределение памяти) не встраиваются в вызывающий код и размещаются отдельно от горячего
+#if defined(__GNUC__) || defined(__clang__)
+#define VECTOR_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define VECTOR_COLD __declspec(noinline)
+#else
+#define VECTOR_COLD
+#endif
+
+// Отладочный режим включается макросом VECTOR_HARDENED=1 (опция ADVANCED_VECTOR_HARDENED в CMake): Vector
+// проверяет индексы, PopBack пустого вектора и позиции вставки и удаления, итераторы запоминают поколение
+// буфера и ловят использование после перераспределения, а под AddressSanitizer свободная ёмкость
+// [Size(), Capacity()) отравлена. По умолчанию режим выключен, и проверки не порождают кода
+#ifndef VECTOR_HARDENED
+#define VECTOR_HARDENED 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define VECTOR_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define VECTOR_ASAN 1
+#endif
+#endif
+#ifndef VECTOR_ASAN
+#define VECTOR_ASAN 0
+#endif
+
+#if VECTOR_HARDENED && VECTOR_ASAN
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+#if VECTOR_HARDENED
+#include <cstdio>
+
+namespace vector_hardening {
+
+[[noreturn]] VECTOR_COLD inline void Fail(const char *message, const char *file, int line) noexcept {
+	std::fprintf(stderr, "%s:%d: Vector check failed: %s\n", file, line, message);
+	std::abort();
+}
+
+}  // namespace vector_hardening
+
+#define VECTOR_CHECK(condition, message) \
+	((condition) ? void(0) : vector_hardening::Fail(message, __FILE__, __LINE__))
+#else
+#define VECTOR_CHECK(condition, message) ((void)0)
+#endif
+
+// Признак того, что аллокатор сообщает фактический размер выделенного блока в элементах:
+// size_t usable_size(T *p, size_t n) const. Возвращённое значение затем передаётся в deallocate
+template<typename Allocator, typename = void>
+struct HasUsableSize : std::false_type {
+};
+
+template<typename Allocator>
+struct HasUsableSize<Allocator, std::void_t<decltype(std::declval<const Allocator&>().usable_size(
+		std::declval<typename Allocator::value_type*>(), size_t()))>> : std::true_type {
+};
+
+template<typename T, typename Allocator = std::allocator<T>>
 class RawMemory {
+	using AllocTraits = std::allocator_traits<Allocator>;
 public:
+	using allocator_type = Allocator;
+
 	RawMemory() = default;
 
-	explicit RawMemory(size_t capacity) :
-			buffer_(Allocate(capacity)), capacity_(capacity) {
+	constexpr explicit RawMemory(const Allocator &alloc) noexcept :
+			alloc_(alloc) {
+	}
+
+	constexpr explicit RawMemory(size_t capacity, const Allocator &alloc = Allocator()) :
+			alloc_(alloc), buffer_(Allocate(capacity)), capacity_(UsableCapacity(buffer_, capacity)) {
+	}
+
+	// Забирает буфер buffer на capacity элементов, выделенный аллокатором, равным alloc
+	constexpr RawMemory(T *buffer, size_t capacity, const Allocator &alloc) noexcept :
+			alloc_(alloc), buffer_(buffer), capacity_(capacity) {
 	}
+
 	RawMemory(const RawMemory&) = delete;
 	RawMemory& operator=(const RawMemory &rhs) = delete;
-	RawMemory(RawMemory &&other) noexcept {
-		*this = std::move(other);
+	constexpr RawMemory(RawMemory &&other) noexcept :
+			alloc_(std::move(other.alloc_)), buffer_(std::exchange(other.buffer_, nullptr)), capacity_(std::exchange(other.capacity_, 0)) {
 	}
-	RawMemory& operator=(RawMemory &&rhs) noexcept {
+	// Забирает и буфер, и аллокатор rhs. Решение о том, можно ли менять аллокатор, принимает владелец
+	constexpr RawMemory& operator=(RawMemory &&rhs) noexcept {
 		if (this != &rhs) {
-			buffer_ = std::move(rhs.buffer_);
-			capacity_ = std::move(rhs.Capacity());
-			rhs.buffer_ = nullptr;
-			rhs.capacity_ = 0;
+			Deallocate(buffer_, capacity_);
+			alloc_ = std::move(rhs.alloc_);
+			buffer_ = std::exchange(rhs.buffer_, nullptr);
+			capacity_ = std::exchange(rhs.capacity_, 0);
 		}
 		return *this;
 	}
 
-	~RawMemory() {
-		Deallocate(buffer_);
+	constexpr ~RawMemory() {
+		Deallocate(buffer_, capacity_);
 	}
 
-	T* operator+(size_t offset) noexcept {
+	constexpr T* operator+(size_t offset) noexcept {
 		// Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
 		assert(offset <= capacity_);
 		return buffer_ + offset;
 	}
 
-	const T* operator+(size_t offset) const noexcept {
+	constexpr const T* operator+(size_t offset) const noexcept {
 		return const_cast<RawMemory&>(*this) + offset;
 	}
 
-	const T& operator[](size_t index) const noexcept {
+	constexpr const T& operator[](size_t index) const noexcept {
 		return const_cast<RawMemory&>(*this)[index];
 	}
 
-	T& operator[](size_t index) noexcept {
+	constexpr T& operator[](size_t index) noexcept {
 		assert(index < capacity_);
 		return buffer_[index];
 	}
 
-	void Swap(RawMemory &other) noexcept {
+	constexpr void Swap(RawMemory &other) noexcept {
+		using std::swap;
+		swap(alloc_, other.alloc_);
+		SwapBuffers(other);
+	}
+
+	// Обменивает только буферы, аллокаторы остаются на месте (они должны быть равны)
+	constexpr void SwapBuffers(RawMemory &other) noexcept {
 		std::swap(buffer_, other.buffer_);
 		std::swap(capacity_, other.capacity_);
 	}
 
-	const T* GetAddress() const noexcept {
+	// Отдаёт буфер вызывающему, который становится ответственным за его освобождение
+	constexpr T* Release() noexcept {
+		capacity_ = 0;
+		return std::exchange(buffer_, nullptr);
+	}
+
+	constexpr const T* GetAddress() const noexcept {
 		return buffer_;
 	}
 
-	T* GetAddress() noexcept {
+	constexpr T* GetAddress() noexcept {
 		return buffer_;
 	}
 
-	size_t Capacity() const {
+	constexpr size_t Capacity() const {
 		return capacity_;
 	}
 
+	// Изменяет ёмкость, по возможности не перемещая буфер. Доступно, только если аллокатор поддерживает
+	// reallocate, и годится лишь для тривиально перемещаемых элементов
+	void Reallocate(size_t new_capacity) {
+		static_assert(HasReallocate<Allocator>::value, "Allocator does not support reallocate");
+		if (buffer_ == nullptr) {
+			buffer_ = Allocate(new_capacity);
+		} else {
+			buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+		}
+		capacity_ = UsableCapacity(buffer_, new_capacity);
+	}
+
+	constexpr const Allocator& GetAllocator() const noexcept {
+		return alloc_;
+	}
+
+	constexpr Allocator& GetAllocator() noexcept {
+		return alloc_;
+	}
+
 private:
 	// Выделяет сырую память под n элементов и возвращает указатель на неё
-	static T* Allocate(size_t n) {
-		return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+	constexpr T* Allocate(size_t n) {
+		return n != 0 ? AllocTraits::allocate(alloc_, n) : nullptr;
 	}
 
-	// Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-	static void Deallocate(T *buf) noexcept {
-		operator delete(buf);
+	// Реальная ёмкость блока, выделенного под n элементов
+	constexpr size_t UsableCapacity(T *buf, size_t n) const noexcept {
+		if constexpr (HasUsableSize<Allocator>::value) {
+			return buf != nullptr ? alloc_.usable_size(buf, n) : n;
+		} else {
+			return n;
+		}
 	}
 
+	// Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+	constexpr void Deallocate(T *buf, size_t n) noexcept {
+		if (buf != nullptr) {
+			AllocTraits::deallocate(alloc_, buf, n);
+		}
+	}
+
+	[[no_unique_address]] Allocator alloc_;
 	T *buffer_ = nullptr;
 	size_t capacity_ = 0;
 };
 
+// Признак того, что It является итератором (а не, например, счётчиком элементов)
+template<typename It, typename = void>
+struct IsIterator : std::false_type {
+};
+
+template<typename It>
+struct IsIterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>> : std::true_type {
+};
+
+// Итератор, count раз возвращающий одно и то же значение. Позволяет вставлять count копий значения
+// тем же кодом, что и диапазон
+template<typename T>
+class RepeatIterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+	constexpr RepeatIterator(const T &value, size_t index) noexcept :
+			value_(&value), index_(index) {
+	}
+
+	constexpr reference operator*() const noexcept {
+		return *value_;
+	}
+	constexpr pointer operator->() const noexcept {
+		return value_;
+	}
+	constexpr RepeatIterator& operator++() noexcept {
+		++index_;
+		return *this;
+	}
+	constexpr RepeatIterator operator++(int) noexcept {
+		RepeatIterator old = *this;
+		++index_;
+		return old;
+	}
+	constexpr bool operator==(const RepeatIterator &other) const noexcept {
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const RepeatIterator &other) const noexcept {
+		return index_ != other.index_;
+	}
+
+private:
+	const T *value_;
+	size_t index_;
+};
+
+// Буфер, отданный вектором через Release: size созданных элементов в памяти на capacity элементов
 template<typename T>
+struct VectorBuffer {
+	T *data = nullptr;
+	size_t size = 0;
+	size_t capacity = 0;
+};
+
+// Тег конструктора, создающего элементы инициализацией по умолчанию: для int, float и других
+// тривиальных типов память не заполняется нулями, а остаётся с неопределённым содержимым
+struct DefaultInitTag {
+};
+
+inline constexpr DefaultInitTag kDefaultInit{};
+
+// Тег операций, которые для больших векторов делятся на части и выполняются в нескольких потоках.
+// Каждый поток сам записывает свою часть нового буфера, поэтому при первом касании её страницы
+// размещаются на NUMA-узле этого потока. Небольшие векторы обрабатываются в текущем потоке
+struct ParallelTag {
+};
+
+inline constexpr ParallelTag kParallel{};
+
+// Меньший объём данных на поток не окупает запуск потока
+inline constexpr size_t kParallelMinBytesPerThread = size_t(4) << 20;
+
+// Делит [0, count) на равные части и вызывает body(first, last) для каждой, по потоку на часть.
+// Если какая-то часть бросила исключение, для успешно обработанных частей вызывается rollback(first, last),
+// и первое исключение пробрасывается дальше. Часть, для которой не удалось запустить поток,
+// выполняется в текущем потоке
+template<typename Body, typename Rollback>
+void ParallelChunks(size_t count, size_t item_size, Body body, Rollback rollback,
+		size_t max_threads = std::thread::hardware_concurrency()) {
+	const size_t min_items = std::max<size_t>(kParallelMinBytesPerThread / item_size, 1);
+	const size_t threads = std::clamp<size_t>(count / min_items, 1, std::max<size_t>(max_threads, 1));
+	if (threads == 1) {
+		body(size_t(0), count);
+		return;
+	}
+	const size_t chunk = (count + threads - 1) / threads;
+	auto first = [=](size_t i) {
+		return std::min(i * chunk, count);
+	};
+	auto last = [=](size_t i) {
+		return std::min((i + 1) * chunk, count);
+	};
+	std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[threads]);
+	std::unique_ptr<std::thread[]> workers(new std::thread[threads]);
+	auto run = [&](size_t i) noexcept {
+		try {
+			body(first(i), last(i));
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+	};
+	for (size_t i = 1; i < threads; ++i) {
+		try {
+			workers[i] = std::thread(run, i);
+		} catch (const std::system_error&) {
+			run(i);
+		}
+	}
+	run(0);
+	std::exception_ptr error;
+	for (size_t i = 0; i < threads; ++i) {
+		if (workers[i].joinable()) {
+			workers[i].join();
+		}
+		if (errors[i] && !error) {
+			error = errors[i];
+		}
+	}
+	if (error) {
+		for (size_t i = 0; i < threads; ++i) {
+			if (!errors[i]) {
+				rollback(first(i), last(i));
+			}
+		}
+		std::rethrow_exception(error);
+	}
+}
+
+// Политика инструментирования Vector по умолчанию: все события пустые и исчезают при компиляции.
+// Собственная политика должна предоставить те же статические функции (см. CountingInstrumentation)
+struct NoInstrumentation {
+	// Выделен новый буфер на capacity элементов размером bytes байт
+	static constexpr void OnAllocate(size_t, size_t) noexcept {
+	}
+	// Заполненный буфер заменён более ёмким, в него перенесено relocated элементов
+	static constexpr void OnReallocate(size_t) noexcept {
+	}
+	// Размер вектора вырос до size при ёмкости capacity
+	static constexpr void OnSize(size_t, size_t) noexcept {
+	}
+};
+
+template<typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+		typename Instrumentation = NoInstrumentation>
 class Vector {
+	using AllocTraits = std::allocator_traits<Allocator>;
+
+#if VECTOR_HARDENED
+	// Итератор отладочного режима: помнит вектор и поколение его буфера и при разыменовании проверяет,
+	// что буфер с тех пор не менялся, а сам итератор указывает на элемент
+	template<typename U>
+	class CheckedIterator {
+	public:
+		using iterator_concept = std::contiguous_iterator_tag;
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::remove_cv_t<U>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = U*;
+		using reference = U&;
+
+		CheckedIterator() = default;
+
+		constexpr CheckedIterator(const Vector *owner, U *item) noexcept :
+				owner_(owner), item_(item), generation_(owner->generation_) {
+		}
+
+		template<typename V, std::enable_if_t<std::is_same_v<const V, U> && !std::is_same_v<V, U>, int> = 0>
+		constexpr CheckedIterator(const CheckedIterator<V> &other) noexcept :
+				owner_(other.owner_), item_(other.item_), generation_(other.generation_) {
+		}
+
+		constexpr U& operator*() const noexcept {
+			CheckItem(item_);
+			return *item_;
+		}
+		// Не проверяет границы: через operator-> std::to_address получает адрес в том числе для end()
+		constexpr U* operator->() const noexcept {
+			CheckValid();
+			return item_;
+		}
+		constexpr U& operator[](difference_type offset) const noexcept {
+			CheckItem(item_ + offset);
+			return item_[offset];
+		}
+
+		constexpr CheckedIterator& operator++() noexcept {
+			++item_;
+			return *this;
+		}
+		constexpr CheckedIterator operator++(int) noexcept {
+			CheckedIterator old = *this;
+			++item_;
+			return old;
+		}
+		constexpr CheckedIterator& operator--() noexcept {
+			--item_;
+			return *this;
+		}
+		constexpr CheckedIterator operator--(int) noexcept {
+			CheckedIterator old = *this;
+			--item_;
+			return old;
+		}
+		constexpr CheckedIterator& operator+=(difference_type offset) noexcept {
+			item_ += offset;
+			return *this;
+		}
+		constexpr CheckedIterator& operator-=(difference_type offset) noexcept {
+			item_ -= offset;
+			return *this;
+		}
+		constexpr CheckedIterator operator+(difference_type offset) const noexcept {
+			return CheckedIterator(*this) += offset;
+		}
+		friend constexpr CheckedIterator operator+(difference_type offset, const CheckedIterator &it) noexcept {
+			return it + offset;
+		}
+		constexpr CheckedIterator operator-(difference_type offset) const noexcept {
+			return CheckedIterator(*this) -= offset;
+		}
+		constexpr difference_type operator-(const CheckedIterator &other) const noexcept {
+			CheckSameVector(other);
+			return item_ - other.item_;
+		}
+
+		constexpr bool operator==(const CheckedIterator &other) const noexcept {
+			CheckSameVector(other);
+			return item_ == other.item_;
+		}
+		constexpr auto operator<=>(const CheckedIterator &other) const noexcept {
+			CheckSameVector(other);
+			return item_ <=> other.item_;
+		}
+
+	private:
+		template<typename>
+		friend class CheckedIterator;
+		friend class Vector;
+
+		constexpr void CheckValid() const noexcept {
+			VECTOR_CHECK(owner_ != nullptr, "singular iterator");
+			VECTOR_CHECK(generation_ == owner_->generation_, "iterator used after the buffer was reallocated");
+		}
+
+		constexpr void CheckItem(const U *item) const noexcept {
+			CheckValid();
+			const std::less<const U*> less;
+			VECTOR_CHECK(!less(item, owner_->data_.GetAddress()) && less(item, owner_->data_.GetAddress() + owner_->size_),
+					"dereferencing an iterator outside [begin(), end())");
+		}
+
+		constexpr void CheckSameVector(const CheckedIterator &other) const noexcept {
+			VECTOR_CHECK(owner_ == other.owner_, "comparing iterators of different vectors");
+		}
+
+		const Vector *owner_ = nullptr;
+		U *item_ = nullptr;
+		size_t generation_ = 0;
+	};
+#endif
+
 public:
+#if VECTOR_HARDENED
+	using iterator = CheckedIterator<T>;
+	using const_iterator = CheckedIterator<const T>;
+#else
 	using iterator = T*;
 	using const_iterator = const T*;
+#endif
+	using allocator_type = Allocator;
 
 	Vector() = default;
 
-	explicit Vector(size_t size) :
-			data_(size), size_(size) {
-		std::uninitialized_value_construct_n(data_.GetAddress(), size);
+	constexpr explicit Vector(const Allocator &alloc) noexcept :
+			data_(alloc) {
+	}
+
+	constexpr explicit Vector(size_t size, const Allocator &alloc = Allocator()) :
+			data_(size, alloc), size_(size) {
+		UninitializedValueConstructN(data_.GetAddress(), size);
+		AnnotateCapacity(data_.Capacity(), size_);
+		NoteAllocation();
+		NoteSize();
+	}
+
+	constexpr Vector(size_t size, DefaultInitTag, const Allocator &alloc = Allocator()) :
+			data_(size, alloc), size_(size) {
+		UninitializedDefaultConstructN(data_.GetAddress(), size);
+		AnnotateCapacity(data_.Capacity(), size_);
+		NoteAllocation();
+		NoteSize();
+	}
+
+	// Как Vector(size), но большой вектор заполняется в нескольких потоках
+	Vector(size_t size, ParallelTag, const Allocator &alloc = Allocator()) :
+			data_(size, alloc), size_(size) {
+		T *buffer = data_.GetAddress();
+		ParallelChunks(size, sizeof(T), [buffer](size_t first, size_t last) {
+			std::uninitialized_value_construct_n(buffer + first, last - first);
+		}, [buffer](size_t first, size_t last) noexcept {
+			std::destroy(buffer + first, buffer + last);
+		});
+		AnnotateCapacity(data_.Capacity(), size_);
+		NoteAllocation();
+		NoteSize();
+	}
+
+	// Забирает буфер buffer, в начале которого уже созданы size элементов
+	constexpr Vector(RawMemory<T, Allocator> &&buffer, size_t size) noexcept :
+			data_(std::move(buffer)), size_(size) {
+		assert(size_ <= data_.Capacity());
+		AnnotateCapacity(data_.Capacity(), size_);
+	}
+
+	constexpr Vector(std::initializer_list<T> items, const Allocator &alloc = Allocator()) :
+			data_(items.size(), alloc), size_(items.size()) {
+		UninitializedCopyN(items.begin(), items.size(), data_.GetAddress());
+		AnnotateCapacity(data_.Capacity(), size_);
+		NoteAllocation();
+		NoteSize();
 	}
 
-	Vector(const Vector &other) :
-			data_(other.size_), size_(other.size_) {
-		std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+	constexpr Vector(const Vector &other) :
+			Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
 	}
 
-	Vector& operator=(const Vector &other) {
+	constexpr Vector(const Vector &other, const Allocator &alloc) :
+			data_(other.size_, alloc), size_(other.size_) {
+		UninitializedCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+		AnnotateCapacity(data_.Capacity(), size_);
+		NoteAllocation();
+		NoteSize();
+	}
+
+	// Копирование большого вектора в нескольких потоках
+	Vector(const Vector &other, ParallelTag) :
+			data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator())), size_(other.size_) {
+		ParallelCopy(other.data_.GetAddress(), other.size_, data_.GetAddress());
+		AnnotateCapacity(data_.Capacity(), size_);
+		NoteAllocation();
+		NoteSize();
+	}
+
+	constexpr Vector& operator=(const Vector &other) {
 		if (this != &other) {
-			if (other.size_ <= data_.Capacity()) {
-				if (size_ <= other.size_) {
-					std::copy(other.data_.GetAddress(), other.data_.GetAddress() + size_, data_.GetAddress());
-					std::uninitialized_copy_n(other.data_.GetAddress() + size_, other.size_ - size_, data_.GetAddress() + size_);
+			if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+				if (GetAllocator() != other.GetAllocator()) {
+					// Память, выделенную старым аллокатором, нужно вернуть ему же
+					Clear();
+					AnnotateCapacity(0, data_.Capacity());
+					InvalidateIterators();
+					data_ = RawMemory<T, Allocator>(other.GetAllocator());
 				} else {
-					std::copy(other.data_.GetAddress(), other.data_.GetAddress() + other.size_, data_.GetAddress());
-					std::destroy_n(data_.GetAddress() + other.size_, size_ - other.size_);
+					data_.GetAllocator() = other.GetAllocator();
 				}
-				size_ = other.size_;
-			} else {
-				Vector other_copy(other);
-				Swap(other_copy);
 			}
+			AssignFrom(other.data_.GetAddress(), other.size_);
 		}
 		return *this;
 	}
 
-	Vector(Vector &&other) noexcept {
-		*this = std::move(other);
+	constexpr Vector(Vector &&other) noexcept :
+			data_(std::move(other.data_)), size_(std::exchange(other.size_, 0)) {
+		other.InvalidateIterators();
 	}
 
-	Vector& operator=(Vector &&other) noexcept {
-		data_ = std::move(other.data_);
-		size_ = std::move(other.size_);
-		other.size_ = 0;
+	constexpr Vector(Vector &&other, const Allocator &alloc) :
+			data_(alloc) {
+		if (alloc == other.GetAllocator()) {
+			data_.SwapBuffers(other.data_);
+			size_ = std::exchange(other.size_, 0);
+			other.InvalidateIterators();
+		} else {
+			RawMemory<T, Allocator> new_data(other.size_, alloc);
+			UninitializedMoveN(other.data_.GetAddress(), other.size_, new_data.GetAddress());
+			data_.Swap(new_data);
+			size_ = other.size_;
+			AnnotateCapacity(data_.Capacity(), size_);
+			NoteAllocation();
+			NoteSize();
+		}
+	}
+
+	constexpr Vector& operator=(Vector &&other) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+			|| AllocTraits::is_always_equal::value) {
+		if (this != &other) {
+			if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+				Clear();
+				AnnotateCapacity(0, data_.Capacity());
+				data_ = std::move(other.data_);
+				size_ = std::exchange(other.size_, 0);
+				InvalidateIterators();
+				other.InvalidateIterators();
+			} else {
+				if (GetAllocator() == other.GetAllocator()) {
+					Clear();
+					AnnotateCapacity(0, data_.Capacity());
+					data_.SwapBuffers(other.data_);
+					size_ = std::exchange(other.size_, 0);
+					other.AnnotateCapacity(other.data_.Capacity(), 0);
+					InvalidateIterators();
+					other.InvalidateIterators();
+				} else {
+					// Аллокаторы не равны и не распространяются: буфер other забрать нельзя
+					AssignFrom(std::make_move_iterator(other.data_.GetAddress()), other.size_);
+				}
+			}
+		}
 		return *this;
 	}
 
-	void Reserve(size_t new_capacity) {
-		if (new_capacity <= data_.Capacity()) {
-			return;
+	constexpr void Reserve(size_t new_capacity) {
+		if (new_capacity > data_.Capacity()) {
+			Regrow(new_capacity, size_, 0, NoFill());
 		}
-		RawMemory<T> new_data(new_capacity);
-		if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-			std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+	}
+
+	// Как Reserve, но элементы большого вектора переносятся в новый буфер в нескольких потоках
+	void Reserve(size_t new_capacity, ParallelTag) {
+		if constexpr (kReallocInPlace) {
+			Reserve(new_capacity);
 		} else {
-			std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+			if (new_capacity > data_.Capacity()) {
+				Regrow<true>(new_capacity, size_, 0, NoFill());
+			}
 		}
-		std::destroy_n(data_.GetAddress(), size_);
-		data_.Swap(new_data);
 	}
 
-	void Swap(Vector &other) noexcept {
-		data_.Swap(other.data_), std::swap(size_, other.size_);
+	// Уменьшает ёмкость до max(Size(), target_capacity). Элементы переносятся тем же способом, что и при
+	// росте, а если аллокатор умеет reallocate, буфер ужимается на месте
+	constexpr void Trim(size_t target_capacity) {
+		const size_t new_capacity = std::max(size_, target_capacity);
+		const size_t old_capacity = data_.Capacity();
+		if (new_capacity >= old_capacity) {
+			return;
+		}
+		if (new_capacity == 0) {
+			RawMemory<T, Allocator> released(data_.GetAllocator());
+			AnnotateCapacity(0, old_capacity);
+			data_.SwapBuffers(released);
+			InvalidateIterators();
+			return;
+		}
+		Regrow(new_capacity, size_, 0, NoFill());
+	}
+
+	// Освобождает всю неиспользуемую ёмкость
+	constexpr void ShrinkToFit() {
+		Trim(0);
+	}
+
+	// Разрушает все элементы, сохраняя ёмкость
+	constexpr void Clear() noexcept {
+		DestroyTail(0);
+	}
+
+	// Заменяет каждый элемент x на fn(x)
+	template<typename F>
+	constexpr void Transform(F fn) {
+		for (T &item : *this) {
+			item = fn(item);
+		}
+	}
+
+	// Параллельный Transform; fn вызывается одновременно из нескольких потоков. При исключении
+	// часть элементов может остаться уже преобразованной
+	template<typename F>
+	void Transform(F fn, ParallelTag) {
+		T *buffer = data_.GetAddress();
+		ParallelChunks(size_, sizeof(T), [buffer, &fn](size_t first, size_t last) {
+			for (T *item = buffer + first; item != buffer + last; ++item) {
+				*item = fn(*item);
+			}
+		}, [](size_t, size_t) noexcept {
+		});
+	}
+
+	// Забирает буфер buffer на capacity элементов, в начале которого созданы size элементов.
+	// Буфер должен быть выделен аллокатором, равным GetAllocator(); прежнее содержимое освобождается
+	void Adopt(T *buffer, size_t size, size_t capacity) noexcept {
+		assert(size <= capacity);
+		Clear();
+		AnnotateCapacity(0, data_.Capacity());
+		RawMemory<T, Allocator> adopted(buffer, capacity, data_.GetAllocator());
+		data_.SwapBuffers(adopted);
+		size_ = size;
+		AnnotateCapacity(data_.Capacity(), size_);
+		InvalidateIterators();
+		NoteSize();
 	}
 
-	void Resize(size_t new_size) {
+	// Забирает чужой буфер, который освободит deleter(buffer, capacity). Доступно аллокаторам,
+	// создаваемым из буфера и его deleter, например AdoptingAllocator. Если создать аллокатор не удалось,
+	// исключение пробрасывается, а буфер остаётся у вызывающего
+	template<typename Deleter, std::enable_if_t<std::is_constructible_v<Allocator, T*, Deleter>, int> = 0>
+	void Adopt(T *buffer, size_t size, size_t capacity, Deleter deleter) {
+		static_assert(AllocTraits::propagate_on_container_move_assignment::value,
+				"Allocator must travel with the adopted buffer");
+		assert(size <= capacity);
+		*this = Vector(RawMemory<T, Allocator>(buffer, capacity, Allocator(buffer, std::move(deleter))), size);
+	}
+
+	// Отдаёт буфер вместе с элементами и оставляет вектор пустым. Разрушить элементы и вернуть память
+	// аллокатору GetAllocator() должен вызывающий
+	VectorBuffer<T> Release() noexcept {
+		const size_t capacity = data_.Capacity();
+		AnnotateCapacity(size_, capacity);
+		InvalidateIterators();
+		return VectorBuffer<T>{data_.Release(), std::exchange(size_, 0), capacity};
+	}
+
+	constexpr void Swap(Vector &other) noexcept {
+		if constexpr (AllocTraits::propagate_on_container_swap::value) {
+			data_.Swap(other.data_);
+		} else {
+			assert(GetAllocator() == other.GetAllocator());
+			data_.SwapBuffers(other.data_);
+		}
+		std::swap(size_, other.size_);
+		InvalidateIterators();
+		other.InvalidateIterators();
+	}
+
+	constexpr void Resize(size_t new_size) {
 		if (new_size == size_) {
 			return;
 		} else if (new_size < size_) {
-			std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
-			size_ = new_size;
+			DestroyTail(new_size);
 		} else {
 			Reserve(new_size);
-			std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+			ConstructInSpare(new_size, [this, new_size] {
+				UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
+			});
 			size_ = new_size;
+			NoteSize();
 		}
 	}
 
-	template<typename M>
-	void PushBack(M &&value) {
-		if (data_.Capacity() == size_) {
-			RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-			new (new_data.GetAddress() + size_) T(std::forward<M>(value));
-			if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-				std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-			} else {
-				std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-			}
-			std::destroy_n(data_.GetAddress(), size_);
-			data_.Swap(new_data);
-		} else {
-			new (data_.GetAddress() + size_) T(std::forward<M>(value));
+	// Как Resize, но новые элементы инициализируются по умолчанию, а не значением
+	constexpr void ResizeDefaultInit(size_t new_size) {
+		if (new_size < size_) {
+			DestroyTail(new_size);
+		} else if (new_size > size_) {
+			Reserve(new_size);
+			ConstructInSpare(new_size, [this, new_size] {
+				UninitializedDefaultConstructN(data_.GetAddress() + size_, new_size - size_);
+			});
+			size_ = new_size;
+			NoteSize();
 		}
-		++size_;
+	}
+
+	// Изменяет размер, оставляя новые элементы неинициализированными. Перед чтением их нужно записать
+	constexpr void ResizeUninitialized(size_t new_size) {
+		static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+				"ResizeUninitialized requires a trivial element type");
+		ResizeDefaultInit(new_size);
+	}
+
+	template<typename M>
+	constexpr void PushBack(M &&value) {
+		EmplaceBack(std::forward<M>(value));
 	}
 
 	template<typename ... Args>
-	T& EmplaceBack(Args &&... args) {
-		if (data_.Capacity() == size_) {
-			RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-			new (new_data.GetAddress() + size_) T(std::forward<Args>(args) ...);
-			if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-				std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-			} else {
-				std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-			}
-			std::destroy_n(data_.GetAddress(), size_);
-			data_.Swap(new_data);
+	constexpr T& EmplaceBack(Args &&... args) {
+		if (data_.Capacity() == size_) [[unlikely]] {
+			Regrow(NextCapacity(), size_, 1, [&args...](T *dest) {
+				std::construct_at(dest, std::forward<Args>(args)...);
+			});
 		} else {
-			new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+			ConstructInSpare(size_ + 1, [this, &args...] {
+				std::construct_at(data_.GetAddress() + size_, std::forward<Args>(args)...);
+			});
 		}
-		return data_[size_++];
+		++size_;
+		NoteSize();
+		return data_[size_ - 1];
 	}
 
 	template<typename ... Args>
-	iterator Emplace(const_iterator pos, Args &&... args) {
-		int pos_index = pos - begin();
-		if (data_.Capacity() == size_) {
-			RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-			new (new_data.GetAddress() + pos_index) T(std::forward<Args>(args) ...);
-			if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-				std::uninitialized_move_n(data_.GetAddress(), pos_index, new_data.GetAddress());
-				std::uninitialized_move_n(data_.GetAddress() + pos_index, size_ - pos_index, new_data.GetAddress() + pos_index + 1);
-			} else {
-				std::uninitialized_copy_n(data_.GetAddress(), pos_index, new_data.GetAddress());
-				std::uninitialized_copy_n(data_.GetAddress() + pos_index, size_ - pos_index, new_data.GetAddress() + pos_index + 1);
-			}
-			std::destroy_n(data_.GetAddress(), size_);
-			data_.Swap(new_data);
+	constexpr iterator Emplace(const_iterator pos, Args &&... args) {
+		const size_t pos_index = IndexOf(pos);
+		if (data_.Capacity() == size_) [[unlikely]] {
+			Regrow(NextCapacity(), pos_index, 1, [&args...](T *dest) {
+				std::construct_at(dest, std::forward<Args>(args)...);
+			});
 		} else {
-			try {
-				if (pos == end()) {
-					new (end()) T(std::forward<Args>(args)...);
+			ConstructInSpare(size_ + 1, [this, pos_index, &args...] {
+				if (pos_index == size_) {
+					std::construct_at(data_.GetAddress() + size_, std::forward<Args>(args)...);
 				} else {
-					T temp(std::forward<Args>(args)...);
-					new (end()) T(std::forward<T>(data_[size_ - 1]));
-					std::move_backward(begin() + pos_index, end() - 1, end());
-					*(begin() + pos_index) = std::forward<T>(temp);
+					EmplaceInGap(pos_index, std::forward<Args>(args)...);
 				}
-			} catch (...) {
-				operator delete(end());
-				throw;
-			}
+			});
 		}
 		++size_;
-		return begin() + pos_index;
+		NoteSize();
+		return MakeIterator(pos_index);
 	}
 
-	iterator Insert(const_iterator pos, const T &item) {
+	constexpr iterator Insert(const_iterator pos, const T &item) {
 		return Emplace(pos, item);
 	}
-	iterator Insert(const_iterator pos, T &&item) {
+	constexpr iterator Insert(const_iterator pos, T &&item) {
 		return Emplace(pos, std::move(item));
 	}
 
-	iterator Erase(const_iterator pos) {
-		int pos_index = pos - begin();
-		std::move(begin() + pos_index + 1, end(), begin() + pos_index);
-		std::destroy_at(end() - 1);
-		--size_;
-		return begin() + pos_index;
+	constexpr iterator Insert(const_iterator pos, size_t count, const T &value) {
+		if (MayAlias(value)) {
+			// value — элемент самого вектора, который сдвинется при вставке
+			T copy(value);
+			return InsertRange(IndexOf(pos), RepeatIterator<T>(copy, 0), count);
+		}
+		return InsertRange(IndexOf(pos), RepeatIterator<T>(value, 0), count);
+	}
+
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	constexpr iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+		size_t pos_index = IndexOf(pos);
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+			return InsertRange(pos_index, first, std::distance(first, last));
+		} else {
+			// Длину однопроходного диапазона заранее не узнать: дописываем в конец и переставляем на место
+			size_t old_size = size_;
+			Append(first, last);
+			T *items = data_.GetAddress();
+			std::rotate(items + pos_index, items + old_size, items + size_);
+			return MakeIterator(pos_index);
+		}
+	}
+
+	constexpr iterator Insert(const_iterator pos, std::initializer_list<T> items) {
+		return InsertRange(IndexOf(pos), items.begin(), items.size());
 	}
 
-	void PopBack() noexcept {
+	template<typename InputIt, std::enable_if_t<IsIterator<InputIt>::value, int> = 0>
+	constexpr void Append(InputIt first, InputIt last) {
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+			InsertRange(size_, first, std::distance(first, last));
+		} else {
+			for (; first != last; ++first) {
+				EmplaceBack(*first);
+			}
+		}
+	}
+
+	constexpr iterator Erase(const_iterator pos) {
+		VECTOR_CHECK(IndexOf(pos) < size_, "Erase(end())");
+		return Erase(pos, pos + 1);
+	}
+
+	// Удаляет элементы [first, last), сдвигая хвост за один проход
+	constexpr iterator Erase(const_iterator first, const_iterator last) {
+		size_t first_index = IndexOf(first);
+		VECTOR_CHECK(first_index <= IndexOf(last), "Erase of a reversed range");
+		size_t count = last - first;
+		if (count == 0) {
+			return MakeIterator(first_index);
+		}
+		vector_detail::EraseRange(data_.GetAddress(), size_, first_index, count);
+		size_ -= count;
+		AnnotateCapacity(size_ + count, size_);
+		return MakeIterator(first_index);
+	}
+
+	// Удаляет все элементы, для которых pred возвращает true, и возвращает их количество
+	template<typename Predicate>
+	constexpr size_t EraseIf(Predicate pred) {
+		T *items = data_.GetAddress();
+		T *new_end = std::remove_if(items, items + size_, pred);
+		size_t removed = items + size_ - new_end;
+		DestroyTail(new_end - items);
+		return removed;
+	}
+
+	// Удаляет элемент за O(1), ставя на его место последний элемент. Порядок элементов не сохраняется
+	constexpr iterator SwapErase(const_iterator pos) {
+		size_t pos_index = IndexOf(pos);
+		VECTOR_CHECK(pos_index < size_, "SwapErase(end())");
+		if (pos_index != size_ - 1) {
+			data_[pos_index] = std::move(data_[size_ - 1]);
+		}
+		PopBack();
+		return MakeIterator(pos_index);
+	}
+
+	constexpr void PopBack() noexcept {
+		VECTOR_CHECK(size_ != 0, "PopBack on an empty vector");
 		std::destroy_at(data_.GetAddress() + size_ - 1);
 		--size_;
+		AnnotateCapacity(size_ + 1, size_);
 	}
 
-	size_t Size() const noexcept {
+	constexpr size_t Size() const noexcept {
 		return size_;
 	}
 
-	size_t Capacity() const noexcept {
+	constexpr size_t Capacity() const noexcept {
 		return data_.Capacity();
 	}
 
-	const T& operator[](size_t index) const noexcept {
+	constexpr const Allocator& GetAllocator() const noexcept {
+		return data_.GetAllocator();
+	}
+
+	constexpr const T& operator[](size_t index) const noexcept {
+		VECTOR_CHECK(index < size_, "index out of range");
 		return data_[index];
 	}
 
-	T& operator[](size_t index) noexcept {
+	constexpr T& operator[](size_t index) noexcept {
+		VECTOR_CHECK(index < size_, "index out of range");
 		return data_[index];
 	}
 
-	iterator begin() noexcept {
+	// Указатель на первый элемент; в отличие от begin() всегда простой указатель
+	constexpr T* Data() noexcept {
 		return data_.GetAddress();
 	}
-	iterator end() noexcept {
-		return data_.GetAddress() + size_;
-	}
-	const_iterator begin() const noexcept {
+	constexpr const T* Data() const noexcept {
 		return data_.GetAddress();
 	}
-	const_iterator end() const noexcept {
-		return data_.GetAddress() + size_;
+
+	constexpr iterator begin() noexcept {
+		return MakeIterator(0);
+	}
+	constexpr iterator end() noexcept {
+		return MakeIterator(size_);
+	}
+	constexpr const_iterator begin() const noexcept {
+		return MakeIterator(0);
 	}
-	const_iterator cbegin() const noexcept {
+	constexpr const_iterator end() const noexcept {
+		return MakeIterator(size_);
+	}
+	constexpr const_iterator cbegin() const noexcept {
 		return begin();
 	}
-	const_iterator cend() const noexcept {
+	constexpr const_iterator cend() const noexcept {
 		return end();
 	}
 
-	~Vector() {
+	constexpr ~Vector() {
 		std::destroy_n(data_.GetAddress(), size_);
+		AnnotateCapacity(size_, data_.Capacity());
 	}
 
 private:
-	RawMemory<T> data_;
+	// Ёмкость буфера, в который вектор переезжает, когда текущий заполнен
+	constexpr size_t NextCapacity() const noexcept {
+		return GrowthPolicy::NextCapacity(data_.Capacity(), size_ + 1, sizeof(T));
+	}
+
+	// Буфер можно расширять через reallocate аллокатора: элементы переносятся побайтово, конструкторы не нужны
+	static constexpr bool kReallocInPlace = IsTriviallyRelocatableV<T> && HasReallocate<Allocator>::value;
+
+	static constexpr bool kNothrowRelocate = vector_detail::kNothrowRelocate<T>;
+
+	constexpr void OpenGap(size_t pos_index, size_t count) noexcept {
+		vector_detail::OpenGap(data_.GetAddress(), size_, pos_index, count);
+	}
+
+	constexpr void CloseGap(size_t pos_index, size_t count) noexcept {
+		vector_detail::CloseGap(data_.GetAddress(), size_, pos_index, count);
+	}
+
+	template<typename ... Args>
+	constexpr bool MayAlias(const Args &... args) const noexcept {
+		return vector_detail::MayAlias(data_.GetAddress(), size_, args...);
+	}
+
+	template<typename ... Args>
+	constexpr void EmplaceInGap(size_t pos_index, Args &&... args) {
+		vector_detail::EmplaceInGap(data_.GetAddress(), size_, pos_index, std::forward<Args>(args)...);
+	}
+
+	struct NoFill {
+		constexpr void operator()(T*) const noexcept {
+		}
+	};
+
+	// Единственный путь перераспределения памяти: переносит элементы в буфер на new_capacity элементов,
+	// оставляя gap_size ячеек с позиции gap, которые заполняет fill(dest). size_ не меняется.
+	// Новые элементы создаются до переноса старых, поэтому аргументы вставки могут ссылаться на элементы
+	// вектора; для вставки нескольких элементов (gap_size > 1) через reallocate аллокатора это запрещено.
+	// При исключении элементы вектора не меняются. Вынесен из горячих путей вставки
+	template<bool kParallel = false, typename Fill>
+	VECTOR_COLD constexpr void Regrow(size_t new_capacity, size_t gap, size_t gap_size, Fill fill) {
+		const size_t old_capacity = data_.Capacity();
+		// Сколько элементов пришлось перенести: reallocate, расширивший блок на месте, не переносит ничего
+		size_t relocated = size_;
+		if constexpr (kReallocInPlace) {
+			const T *old_address = data_.GetAddress();
+			// Резервирование (NoFill) ячейку не заполняет, и путь через промежуточный слот ему не нужен
+			if constexpr (!std::is_same_v<Fill, NoFill>) {
+				if (gap_size == 1) {
+					alignas(T) unsigned char slot[sizeof(T)];
+					T *item = reinterpret_cast<T*>(slot);
+					fill(item);
+					AnnotateCapacity(size_, old_capacity);
+					try {
+						data_.Reallocate(new_capacity);
+					} catch (...) {
+						AnnotateCapacity(old_capacity, size_);
+						std::destroy_at(item);
+						throw;
+					}
+					AnnotateCapacity(data_.Capacity(), size_ + 1);
+					relocated = data_.GetAddress() == old_address ? 0 : size_;
+					OpenGap(gap, 1);
+					std::memcpy(static_cast<void*>(data_.GetAddress() + gap), static_cast<const void*>(item), sizeof(T));
+					InvalidateIterators();
+					NoteGrowth(old_capacity, relocated);
+					return;
+				}
+			}
+			AnnotateCapacity(size_, old_capacity);
+			try {
+				data_.Reallocate(new_capacity);
+			} catch (...) {
+				AnnotateCapacity(old_capacity, size_);
+				throw;
+			}
+			AnnotateCapacity(data_.Capacity(), size_ + gap_size);
+			relocated = data_.GetAddress() == old_address ? 0 : size_;
+			if (gap_size != 0) {
+				OpenGap(gap, gap_size);
+				try {
+					fill(data_.GetAddress() + gap);
+				} catch (...) {
+					CloseGap(gap, gap_size);
+					AnnotateCapacity(size_ + gap_size, size_);
+					throw;
+				}
+			}
+		} else {
+			RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+			T *dest = new_data.GetAddress() + gap;
+			fill(dest);
+			if constexpr (kParallel) {
+				ParallelRelocate(data_.GetAddress(), size_, new_data.GetAddress());
+			} else {
+				try {
+					UninitializedRelocateAround(data_.GetAddress(), size_, gap, new_data.GetAddress(), gap_size);
+				} catch (...) {
+					std::destroy_n(dest, gap_size);
+					throw;
+				}
+			}
+			AnnotateCapacity(size_, old_capacity);
+			data_.Swap(new_data);
+			AnnotateCapacity(data_.Capacity(), size_ + gap_size);
+		}
+		InvalidateIterators();
+		NoteGrowth(old_capacity, relocated);
+	}
+
+	// Индекс позиции pos. В отладочном режиме проверяет, что pos — действительный итератор этого вектора
+	// в диапазоне [begin(), end()]
+	constexpr size_t IndexOf(const_iterator pos) const noexcept {
+#if VECTOR_HARDENED
+		pos.CheckValid();
+		VECTOR_CHECK(pos.owner_ == this, "iterator belongs to another vector");
+		const size_t index = static_cast<size_t>(pos.item_ - data_.GetAddress());
+		VECTOR_CHECK(index <= size_, "iterator outside [begin(), end()]");
+		return index;
+#else
+		return pos - data_.GetAddress();
+#endif
+	}
+
+	constexpr iterator MakeIterator(size_t index) noexcept {
+#if VECTOR_HARDENED
+		return iterator(this, data_.GetAddress() + index);
+#else
+		return data_.GetAddress() + index;
+#endif
+	}
+
+	constexpr const_iterator MakeIterator(size_t index) const noexcept {
+#if VECTOR_HARDENED
+		return const_iterator(this, data_.GetAddress() + index);
+#else
+		return data_.GetAddress() + index;
+#endif
+	}
+
+	// Буфер сменился: в отладочном режиме все ранее созданные итераторы становятся недействительными
+	constexpr void InvalidateIterators() noexcept {
+#if VECTOR_HARDENED
+		++generation_;
+#endif
+	}
+
+	// Сообщает AddressSanitizer, что доступная часть буфера теперь [0, new_mid) вместо [0, old_mid).
+	// Пишущие за size_ операции сначала открывают нужные ячейки, а перед освобождением или передачей
+	// буфера открывается весь буфер. Вне отладочного режима с ASan ничего не делает
+	constexpr void AnnotateCapacity([[maybe_unused]] size_t old_mid, [[maybe_unused]] size_t new_mid) const noexcept {
+#if VECTOR_HARDENED && VECTOR_ASAN
+		const T *first = data_.GetAddress();
+		// Старые версии ASan принимают только буферы, выровненные на 8 байт
+		if (!std::is_constant_evaluated() && first != nullptr && reinterpret_cast<uintptr_t>(first) % 8 == 0) {
+			__sanitizer_annotate_contiguous_container(first, first + data_.Capacity(), first + old_mid, first + new_mid);
+		}
+#endif
+	}
+
+	// Открывает для ASan ячейки [size_, new_mid) и создаёт в них элементы вызовом construct().
+	// Если construct бросает, всё, что осталось за size_, снова закрывается
+	template<typename Construct>
+	constexpr void ConstructInSpare(size_t new_mid, Construct construct) {
+		AnnotateCapacity(size_, new_mid);
+#if VECTOR_HARDENED && VECTOR_ASAN
+		try {
+			construct();
+		} catch (...) {
+			AnnotateCapacity(new_mid, size_);
+			throw;
+		}
+#else
+		construct();
+#endif
+	}
+
+	// Сообщают политике инструментирования о выделении буфера, его замене и росте размера
+	constexpr void NoteAllocation() const noexcept {
+		if (data_.Capacity() != 0) {
+			Instrumentation::OnAllocate(data_.Capacity() * sizeof(T), data_.Capacity());
+		}
+	}
+
+	constexpr void NoteGrowth(size_t old_capacity, size_t relocated) const noexcept {
+		NoteAllocation();
+		if (old_capacity != 0) {
+			Instrumentation::OnReallocate(relocated);
+		}
+	}
+
+	constexpr void NoteSize() const noexcept {
+		Instrumentation::OnSize(size_, data_.Capacity());
+	}
+
+	// Разрушает элементы начиная с new_size и уменьшает размер до new_size
+	constexpr void DestroyTail(size_t new_size) noexcept {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+		}
+		AnnotateCapacity(size_, new_size);
+		size_ = new_size;
+	}
+
+	// Копирует count элементов из first в неинициализированную память dest. Элементы тривиального типа
+	// из непрерывного диапазона (указатели, итераторы Vector и std::vector) копируются одним memcpy
+	template<typename ForwardIt>
+	static constexpr void UninitializedCopyRange(ForwardIt first, size_t count, T *dest) {
+		if constexpr (std::is_trivially_copyable_v<T> && std::contiguous_iterator<ForwardIt>
+				&& std::is_same_v<std::remove_cv_t<std::iter_value_t<ForwardIt>>, T>) {
+			if (!std::is_constant_evaluated()) {
+				if (count != 0) {
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(std::to_address(first)), count * sizeof(T));
+				}
+				return;
+			}
+		}
+		UninitializedCopyN(first, count, dest);
+	}
+
+	static void ParallelCopy(const T *from, size_t count, T *to) {
+		ParallelChunks(count, sizeof(T), [from, to](size_t first, size_t last) {
+			UninitializedCopyRange(from + first, last - first, to + first);
+		}, [to](size_t first, size_t last) noexcept {
+			std::destroy(to + first, to + last);
+		});
+	}
+
+	// Параллельный UninitializedRelocate. Элементы, которые приходится копировать, разрушаются
+	// в источнике только после успешного копирования всех частей
+	static void ParallelRelocate(T *from, size_t count, T *to) {
+		if constexpr (IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>) {
+			ParallelChunks(count, sizeof(T), [from, to](size_t first, size_t last) {
+				UninitializedRelocate(from + first, last - first, to + first);
+			}, [](size_t, size_t) noexcept {
+			});
+		} else if constexpr (std::is_copy_constructible_v<T>) {
+			ParallelCopy(from, count, to);
+			std::destroy_n(from, count);
+		} else {
+			// Откатить частично выполненное бросающее перемещение нельзя, поэтому переносим последовательно
+			UninitializedRelocate(from, count, to);
+		}
+	}
+
+	// Вставляет count элементов диапазона [first, ...) в позицию pos_index: ёмкость выделяется
+	// не более одного раза, а хвост сдвигается один раз. Диапазон не должен ссылаться на элементы вектора
+	template<typename ForwardIt>
+	constexpr iterator InsertRange(size_t pos_index, ForwardIt first, size_t count) {
+		if (count == 0) {
+			return MakeIterator(pos_index);
+		}
+		const size_t tail = size_ - pos_index;
+		if (size_ + count > data_.Capacity()) {
+			Regrow(GrowthPolicy::NextCapacity(data_.Capacity(), size_ + count, sizeof(T)), pos_index, count,
+					[first, count](T *dest) {
+						UninitializedCopyRange(first, count, dest);
+					});
+		} else if constexpr (kNothrowRelocate) {
+			// Хвост сдвигается один раз, а при исключении возвращается обратно
+			ConstructInSpare(size_ + count, [this, pos_index, first, count] {
+				OpenGap(pos_index, count);
+				try {
+					UninitializedCopyRange(first, count, data_.GetAddress() + pos_index);
+				} catch (...) {
+					CloseGap(pos_index, count);
+					throw;
+				}
+			});
+		} else {
+			T *dest = data_.GetAddress() + pos_index;
+			T *old_end = data_.GetAddress() + size_;
+			// size_ растёт по мере создания элементов за старым концом, поэтому при исключении
+			// ConstructInSpare закрывает только то, что осталось за новым size_
+			ConstructInSpare(size_ + count, [this, first, count, tail, dest, old_end] {
+				if (count < tail) {
+					UninitializedMoveN(old_end - count, count, old_end);
+					size_ += count;
+					std::move_backward(dest, old_end - count, old_end);
+					std::copy_n(first, count, dest);
+				} else {
+					// Часть вставляемых элементов попадает за конец вектора и создаётся на свободном месте
+					ForwardIt middle = std::next(first, tail);
+					UninitializedCopyN(middle, count - tail, old_end);
+					size_ += count - tail;
+					UninitializedMoveN(dest, tail, dest + count);
+					size_ += tail;
+					std::copy(first, middle, dest);
+				}
+			});
+			NoteSize();
+			return MakeIterator(pos_index);
+		}
+		size_ += count;
+		NoteSize();
+		return MakeIterator(pos_index);
+	}
+
+	// Присваивает элементы [first, first + count), по возможности переиспользуя уже выделенную память
+	template<typename RandomIt>
+	constexpr void AssignFrom(RandomIt first, size_t count) {
+		if (count <= data_.Capacity()) {
+			if (size_ <= count) {
+				std::copy_n(first, size_, data_.GetAddress());
+				ConstructInSpare(count, [this, first, count] {
+					UninitializedCopyN(first + size_, count - size_, data_.GetAddress() + size_);
+				});
+			} else {
+				std::copy_n(first, count, data_.GetAddress());
+				std::destroy_n(data_.GetAddress() + count, size_ - count);
+				AnnotateCapacity(size_, count);
+			}
+			size_ = count;
+		} else {
+			RawMemory<T, Allocator> new_data(count, data_.GetAllocator());
+			UninitializedCopyN(first, count, new_data.GetAddress());
+			Clear();
+			AnnotateCapacity(0, data_.Capacity());
+			data_.Swap(new_data);
+			size_ = count;
+			AnnotateCapacity(data_.Capacity(), size_);
+			InvalidateIterators();
+			NoteAllocation();
+		}
+		NoteSize();
+	}
+
+	RawMemory<T, Allocator> data_;
 	size_t size_ = 0;
+#if VECTOR_HARDENED
+	// Растёт при каждой смене буфера; итераторы, созданные с другим поколением, недействительны
+	size_t generation_ = 0;
+#endif
 
 };
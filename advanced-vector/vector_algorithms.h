@@ -0,0 +1,633 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_SIMD_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VECTOR_SIMD_NEON 1
+#endif
+
+#include "vector.h"
+
+// Массовые операции над арифметическими массивами (Vector, столбцы SoAVector и любые std::span).
+// Для float и int32_t используются векторные ядра AVX2/AVX-512 (x86-64, выбор при первом вызове по
+// возможностям процессора) или NEON (AArch64); остальные типы и процессоры обрабатываются скалярным кодом.
+// Хвост массива, не заполняющий целый регистр, всегда обрабатывается поэлементно.
+// Векторные ядра меняют порядок сложения, поэтому Sum и Dot для float могут отличаться от
+// последовательного суммирования в последних разрядах. Min и Max не учитывают NaN
+
+enum class SimdLevel {
+	kScalar,
+	kNeon,
+	kAvx2,
+	kAvx512
+};
+
+inline SimdLevel ActiveSimdLevel() noexcept {
+	static const SimdLevel level = [] {
+#if defined(VECTOR_SIMD_X86)
+		if (__builtin_cpu_supports("avx512f")) {
+			return SimdLevel::kAvx512;
+		}
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+			return SimdLevel::kAvx2;
+		}
+		return SimdLevel::kScalar;
+#elif defined(VECTOR_SIMD_NEON)
+		return SimdLevel::kNeon;
+#else
+		return SimdLevel::kScalar;
+#endif
+	}();
+	return level;
+}
+
+namespace vector_simd {
+
+constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+template<typename T>
+T SumScalar(const T *data, size_t n) noexcept {
+	T sum = T();
+	for (size_t i = 0; i < n; ++i) {
+		sum += data[i];
+	}
+	return sum;
+}
+
+template<typename T>
+T DotScalar(const T *a, const T *b, size_t n) noexcept {
+	T sum = T();
+	for (size_t i = 0; i < n; ++i) {
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+template<typename T>
+T MinScalar(const T *data, size_t n) noexcept {
+	return *std::min_element(data, data + n);
+}
+
+template<typename T>
+T MaxScalar(const T *data, size_t n) noexcept {
+	return *std::max_element(data, data + n);
+}
+
+template<typename T>
+size_t CountScalar(const T *data, size_t n, T value) noexcept {
+	return std::count(data, data + n, value);
+}
+
+template<typename T>
+size_t FindScalar(const T *data, size_t n, T value) noexcept {
+	const T *it = std::find(data, data + n, value);
+	return it == data + n ? kNotFound : it - data;
+}
+
+#if defined(VECTOR_SIMD_X86)
+
+#define VECTOR_SIMD_AVX2 __attribute__((target("avx2,fma")))
+#define VECTOR_SIMD_AVX512 __attribute__((target("avx512f")))
+
+VECTOR_SIMD_AVX2 inline float HorizontalSum(__m256 v) noexcept {
+	__m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+}
+
+VECTOR_SIMD_AVX2 inline int32_t HorizontalSum(__m256i v) noexcept {
+	__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+// Четыре независимых аккумулятора скрывают задержку сложения
+VECTOR_SIMD_AVX2 inline float SumAvx2(const float *data, size_t n) noexcept {
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(data + i));
+		acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(data + i + 8));
+		acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(data + i + 16));
+		acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(data + i + 24));
+	}
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(data + i));
+	}
+	float sum = HorizontalSum(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+	return sum + SumScalar(data + i, n - i);
+}
+
+VECTOR_SIMD_AVX2 inline int32_t SumAvx2(const int32_t *data, size_t n) noexcept {
+	__m256i acc = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc = _mm256_add_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+	}
+	return HorizontalSum(acc) + SumScalar(data + i, n - i);
+}
+
+VECTOR_SIMD_AVX2 inline float DotAvx2(const float *a, const float *b, size_t n) noexcept {
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+		acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+	}
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+	}
+	return HorizontalSum(_mm256_add_ps(acc0, acc1)) + DotScalar(a + i, b + i, n - i);
+}
+
+VECTOR_SIMD_AVX2 inline int32_t DotAvx2(const int32_t *a, const int32_t *b, size_t n) noexcept {
+	__m256i acc = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i product = _mm256_mullo_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+		acc = _mm256_add_epi32(acc, product);
+	}
+	return HorizontalSum(acc) + DotScalar(a + i, b + i, n - i);
+}
+
+template<bool IsMin>
+VECTOR_SIMD_AVX2 inline float MinMaxAvx2(const float *data, size_t n) noexcept {
+	if (n < 8) {
+		return IsMin ? MinScalar(data, n) : MaxScalar(data, n);
+	}
+	__m256 acc = _mm256_loadu_ps(data);
+	size_t i = 8;
+	for (; i + 8 <= n; i += 8) {
+		__m256 v = _mm256_loadu_ps(data + i);
+		acc = IsMin ? _mm256_min_ps(acc, v) : _mm256_max_ps(acc, v);
+	}
+	alignas(32) float lanes[8];
+	_mm256_store_ps(lanes, acc);
+	float result = IsMin ? MinScalar(lanes, 8) : MaxScalar(lanes, 8);
+	for (; i < n; ++i) {
+		result = IsMin ? std::min(result, data[i]) : std::max(result, data[i]);
+	}
+	return result;
+}
+
+template<bool IsMin>
+VECTOR_SIMD_AVX2 inline int32_t MinMaxAvx2(const int32_t *data, size_t n) noexcept {
+	if (n < 8) {
+		return IsMin ? MinScalar(data, n) : MaxScalar(data, n);
+	}
+	__m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+	size_t i = 8;
+	for (; i + 8 <= n; i += 8) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		acc = IsMin ? _mm256_min_epi32(acc, v) : _mm256_max_epi32(acc, v);
+	}
+	alignas(32) int32_t lanes[8];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+	int32_t result = IsMin ? MinScalar(lanes, 8) : MaxScalar(lanes, 8);
+	for (; i < n; ++i) {
+		result = IsMin ? std::min(result, data[i]) : std::max(result, data[i]);
+	}
+	return result;
+}
+
+// Маска совпавших с value элементов блока из восьми чисел, по биту на элемент
+VECTOR_SIMD_AVX2 inline unsigned EqualMask(const float *data, __m256 value) noexcept {
+	return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data), value, _CMP_EQ_OQ));
+}
+
+VECTOR_SIMD_AVX2 inline unsigned EqualMask(const int32_t *data, __m256i value) noexcept {
+	__m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+	return _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+}
+
+VECTOR_SIMD_AVX2 inline __m256 Broadcast(float value) noexcept {
+	return _mm256_set1_ps(value);
+}
+
+VECTOR_SIMD_AVX2 inline __m256i Broadcast(int32_t value) noexcept {
+	return _mm256_set1_epi32(value);
+}
+
+template<typename T>
+VECTOR_SIMD_AVX2 size_t CountAvx2(const T *data, size_t n, T value) noexcept {
+	const auto needle = Broadcast(value);
+	size_t count = 0;
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		count += __builtin_popcount(EqualMask(data + i, needle));
+	}
+	return count + CountScalar(data + i, n - i, value);
+}
+
+template<typename T>
+VECTOR_SIMD_AVX2 size_t FindAvx2(const T *data, size_t n, T value) noexcept {
+	const auto needle = Broadcast(value);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		if (unsigned mask = EqualMask(data + i, needle)) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	size_t tail = FindScalar(data + i, n - i, value);
+	return tail == kNotFound ? kNotFound : i + tail;
+}
+
+// Свёртка через память: _mm512_reduce_add_ps в GCC 12 даёт ложное предупреждение -Wuninitialized
+VECTOR_SIMD_AVX512 inline float HorizontalSum(__m512 v) noexcept {
+	alignas(64) float lanes[16];
+	_mm512_store_ps(lanes, v);
+	return SumScalar(lanes, 16);
+}
+
+VECTOR_SIMD_AVX512 inline float SumAvx512(const float *data, size_t n) noexcept {
+	__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(data + i));
+		acc1 = _mm512_add_ps(acc1, _mm512_loadu_ps(data + i + 16));
+	}
+	for (; i + 16 <= n; i += 16) {
+		acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(data + i));
+	}
+	return HorizontalSum(_mm512_add_ps(acc0, acc1)) + SumScalar(data + i, n - i);
+}
+
+VECTOR_SIMD_AVX512 inline float DotAvx512(const float *a, const float *b, size_t n) noexcept {
+	__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+		acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+	}
+	for (; i + 16 <= n; i += 16) {
+		acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+	}
+	return HorizontalSum(_mm512_add_ps(acc0, acc1)) + DotScalar(a + i, b + i, n - i);
+}
+
+#undef VECTOR_SIMD_AVX2
+#undef VECTOR_SIMD_AVX512
+
+#elif defined(VECTOR_SIMD_NEON)
+
+inline float SumNeon(const float *data, size_t n) noexcept {
+	float32x4_t acc0 = vdupq_n_f32(0), acc1 = vdupq_n_f32(0);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc0 = vaddq_f32(acc0, vld1q_f32(data + i));
+		acc1 = vaddq_f32(acc1, vld1q_f32(data + i + 4));
+	}
+	return vaddvq_f32(vaddq_f32(acc0, acc1)) + SumScalar(data + i, n - i);
+}
+
+inline float DotNeon(const float *a, const float *b, size_t n) noexcept {
+	float32x4_t acc0 = vdupq_n_f32(0), acc1 = vdupq_n_f32(0);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+		acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+	}
+	return vaddvq_f32(vaddq_f32(acc0, acc1)) + DotScalar(a + i, b + i, n - i);
+}
+
+inline int32_t SumNeon(const int32_t *data, size_t n) noexcept {
+	int32x4_t acc = vdupq_n_s32(0);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		acc = vaddq_s32(acc, vld1q_s32(data + i));
+	}
+	return vaddvq_s32(acc) + SumScalar(data + i, n - i);
+}
+
+inline int32_t DotNeon(const int32_t *a, const int32_t *b, size_t n) noexcept {
+	int32x4_t acc = vdupq_n_s32(0);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		acc = vmlaq_s32(acc, vld1q_s32(a + i), vld1q_s32(b + i));
+	}
+	return vaddvq_s32(acc) + DotScalar(a + i, b + i, n - i);
+}
+
+inline float32x4_t Load(const float *data) noexcept {
+	return vld1q_f32(data);
+}
+
+inline int32x4_t Load(const int32_t *data) noexcept {
+	return vld1q_s32(data);
+}
+
+inline float32x4_t Broadcast(float value) noexcept {
+	return vdupq_n_f32(value);
+}
+
+inline int32x4_t Broadcast(int32_t value) noexcept {
+	return vdupq_n_s32(value);
+}
+
+template<bool IsMin>
+inline float32x4_t MinMax(float32x4_t a, float32x4_t b) noexcept {
+	return IsMin ? vminq_f32(a, b) : vmaxq_f32(a, b);
+}
+
+template<bool IsMin>
+inline int32x4_t MinMax(int32x4_t a, int32x4_t b) noexcept {
+	return IsMin ? vminq_s32(a, b) : vmaxq_s32(a, b);
+}
+
+template<bool IsMin>
+inline float ReduceMinMax(float32x4_t v) noexcept {
+	return IsMin ? vminvq_f32(v) : vmaxvq_f32(v);
+}
+
+template<bool IsMin>
+inline int32_t ReduceMinMax(int32x4_t v) noexcept {
+	return IsMin ? vminvq_s32(v) : vmaxvq_s32(v);
+}
+
+// Маска совпавших с value элементов блока из четырёх чисел, по всем битам полосы на элемент
+inline uint32x4_t EqualLanes(const float *data, float32x4_t value) noexcept {
+	return vceqq_f32(vld1q_f32(data), value);
+}
+
+inline uint32x4_t EqualLanes(const int32_t *data, int32x4_t value) noexcept {
+	return vceqq_s32(vld1q_s32(data), value);
+}
+
+template<bool IsMin, typename T>
+inline T MinMaxNeon(const T *data, size_t n) noexcept {
+	if (n < 4) {
+		return IsMin ? MinScalar(data, n) : MaxScalar(data, n);
+	}
+	auto acc = Load(data);
+	size_t i = 4;
+	for (; i + 4 <= n; i += 4) {
+		acc = MinMax<IsMin>(acc, Load(data + i));
+	}
+	T result = ReduceMinMax<IsMin>(acc);
+	for (; i < n; ++i) {
+		result = IsMin ? std::min(result, data[i]) : std::max(result, data[i]);
+	}
+	return result;
+}
+
+template<typename T>
+inline size_t CountNeon(const T *data, size_t n, T value) noexcept {
+	const auto needle = Broadcast(value);
+	size_t count = 0;
+	size_t i = 0;
+	// Полоса совпадения равна 0xFFFFFFFF, то есть -1: вычитание маски прибавляет к счётчику полосы единицу.
+	// За блок полоса насчитывает не больше 2^30 совпадений и не переполняется
+	while (n - i >= 4) {
+		const size_t block_end = i + std::min<size_t>((n - i) / 4, size_t(1) << 30) * 4;
+		uint32x4_t acc = vdupq_n_u32(0);
+		for (; i < block_end; i += 4) {
+			acc = vsubq_u32(acc, EqualLanes(data + i, needle));
+		}
+		count += vaddlvq_u32(acc);
+	}
+	return count + CountScalar(data + i, n - i, value);
+}
+
+template<typename T>
+inline size_t FindNeon(const T *data, size_t n, T value) noexcept {
+	const auto needle = Broadcast(value);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		if (vmaxvq_u32(EqualLanes(data + i, needle)) != 0) {
+			return i + FindScalar(data + i, 4, value);
+		}
+	}
+	size_t tail = FindScalar(data + i, n - i, value);
+	return tail == kNotFound ? kNotFound : i + tail;
+}
+
+#endif
+
+// Типы, для которых есть векторные ядра
+template<typename T>
+inline constexpr bool kHasKernels = std::is_same_v<T, float> || std::is_same_v<T, int32_t>;
+
+}  // namespace vector_simd
+
+template<typename T>
+using EnableIfArithmetic = std::enable_if_t<std::is_arithmetic_v<T>, int>;
+
+template<typename T, EnableIfArithmetic<T> = 0>
+T Sum(std::span<const T> values) noexcept {
+	using namespace vector_simd;
+	if constexpr (kHasKernels<T>) {
+#if defined(VECTOR_SIMD_X86)
+		if constexpr (std::is_same_v<T, float>) {
+			if (ActiveSimdLevel() == SimdLevel::kAvx512) {
+				return SumAvx512(values.data(), values.size());
+			}
+		}
+		if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+			return SumAvx2(values.data(), values.size());
+		}
+#elif defined(VECTOR_SIMD_NEON)
+		return SumNeon(values.data(), values.size());
+#endif
+	}
+	return SumScalar(values.data(), values.size());
+}
+
+// Скалярное произведение массивов одинаковой длины
+template<typename T, EnableIfArithmetic<T> = 0>
+T Dot(std::span<const T> a, std::span<const T> b) noexcept {
+	using namespace vector_simd;
+	assert(a.size() == b.size());
+	if constexpr (kHasKernels<T>) {
+#if defined(VECTOR_SIMD_X86)
+		if constexpr (std::is_same_v<T, float>) {
+			if (ActiveSimdLevel() == SimdLevel::kAvx512) {
+				return DotAvx512(a.data(), b.data(), a.size());
+			}
+		}
+		if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+			return DotAvx2(a.data(), b.data(), a.size());
+		}
+#elif defined(VECTOR_SIMD_NEON)
+		return DotNeon(a.data(), b.data(), a.size());
+#endif
+	}
+	return DotScalar(a.data(), b.data(), a.size());
+}
+
+// Наименьший элемент непустого массива
+template<typename T, EnableIfArithmetic<T> = 0>
+T Min(std::span<const T> values) noexcept {
+	using namespace vector_simd;
+	assert(!values.empty());
+#if defined(VECTOR_SIMD_X86)
+	if constexpr (kHasKernels<T>) {
+		if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+			return MinMaxAvx2<true>(values.data(), values.size());
+		}
+	}
+#elif defined(VECTOR_SIMD_NEON)
+	if constexpr (kHasKernels<T>) {
+		return MinMaxNeon<true>(values.data(), values.size());
+	}
+#endif
+	return MinScalar(values.data(), values.size());
+}
+
+// Наибольший элемент непустого массива
+template<typename T, EnableIfArithmetic<T> = 0>
+T Max(std::span<const T> values) noexcept {
+	using namespace vector_simd;
+	assert(!values.empty());
+#if defined(VECTOR_SIMD_X86)
+	if constexpr (kHasKernels<T>) {
+		if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+			return MinMaxAvx2<false>(values.data(), values.size());
+		}
+	}
+#elif defined(VECTOR_SIMD_NEON)
+	if constexpr (kHasKernels<T>) {
+		return MinMaxNeon<false>(values.data(), values.size());
+	}
+#endif
+	return MaxScalar(values.data(), values.size());
+}
+
+template<typename T, EnableIfArithmetic<T> = 0>
+size_t Count(std::span<const T> values, std::type_identity_t<T> value) noexcept {
+	using namespace vector_simd;
+#if defined(VECTOR_SIMD_X86)
+	if constexpr (kHasKernels<T>) {
+		if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+			return CountAvx2(values.data(), values.size(), value);
+		}
+	}
+#elif defined(VECTOR_SIMD_NEON)
+	if constexpr (kHasKernels<T>) {
+		return CountNeon(values.data(), values.size(), value);
+	}
+#endif
+	return CountScalar(values.data(), values.size(), value);
+}
+
+// Индекс первого элемента, равного value, или values.size(), если такого нет
+template<typename T, EnableIfArithmetic<T> = 0>
+size_t Find(std::span<const T> values, std::type_identity_t<T> value) noexcept {
+	using namespace vector_simd;
+	size_t index = kNotFound;
+#if defined(VECTOR_SIMD_X86)
+	if constexpr (kHasKernels<T>) {
+		if (ActiveSimdLevel() >= SimdLevel::kAvx2) {
+			index = FindAvx2(values.data(), values.size(), value);
+			return index == kNotFound ? values.size() : index;
+		}
+	}
+#elif defined(VECTOR_SIMD_NEON)
+	if constexpr (kHasKernels<T>) {
+		index = FindNeon(values.data(), values.size(), value);
+		return index == kNotFound ? values.size() : index;
+	}
+#endif
+	index = FindScalar(values.data(), values.size(), value);
+	return index == kNotFound ? values.size() : index;
+}
+
+// Перегрузки для std::span<T> и span фиксированной длины: из них шаблонный аргумент std::span<const T>
+// не выводится, поэтому массив передаётся дальше как std::span<const T>
+
+template<typename T>
+using ConstSpan = std::span<const std::remove_const_t<T>>;
+
+template<typename T, size_t Extent, EnableIfArithmetic<std::remove_const_t<T>> = 0>
+std::remove_const_t<T> Sum(std::span<T, Extent> values) noexcept {
+	return Sum(ConstSpan<T>(values));
+}
+
+template<typename A, size_t ExtentA, typename B, size_t ExtentB, EnableIfArithmetic<std::remove_const_t<A>> = 0,
+		std::enable_if_t<std::is_same_v<std::remove_const_t<A>, std::remove_const_t<B>>, int> = 0>
+std::remove_const_t<A> Dot(std::span<A, ExtentA> a, std::span<B, ExtentB> b) noexcept {
+	return Dot(ConstSpan<A>(a), ConstSpan<A>(b));
+}
+
+template<typename T, size_t Extent, EnableIfArithmetic<std::remove_const_t<T>> = 0>
+std::remove_const_t<T> Min(std::span<T, Extent> values) noexcept {
+	return Min(ConstSpan<T>(values));
+}
+
+template<typename T, size_t Extent, EnableIfArithmetic<std::remove_const_t<T>> = 0>
+std::remove_const_t<T> Max(std::span<T, Extent> values) noexcept {
+	return Max(ConstSpan<T>(values));
+}
+
+template<typename T, size_t Extent, EnableIfArithmetic<std::remove_const_t<T>> = 0>
+size_t Count(std::span<T, Extent> values, std::remove_const_t<T> value) noexcept {
+	return Count(ConstSpan<T>(values), value);
+}
+
+template<typename T, size_t Extent, EnableIfArithmetic<std::remove_const_t<T>> = 0>
+size_t Find(std::span<T, Extent> values, std::remove_const_t<T> value) noexcept {
+	return Find(ConstSpan<T>(values), value);
+}
+
+// Заполнение компилятор и так разворачивает в векторные записи, отдельное ядро не требуется
+template<typename T, EnableIfArithmetic<T> = 0>
+void Fill(std::span<T> values, std::type_identity_t<T> value) noexcept {
+	std::fill_n(values.data(), values.size(), value);
+}
+
+// Перегрузки для Vector
+
+template<typename T, typename ... Params>
+std::span<const T> AsSpan(const Vector<T, Params...> &v) noexcept {
+	return std::span<const T>(v.Data(), v.Size());
+}
+
+template<typename T, typename ... Params>
+std::span<T> AsSpan(Vector<T, Params...> &v) noexcept {
+	return std::span<T>(v.Data(), v.Size());
+}
+
+template<typename T, typename ... Params, EnableIfArithmetic<T> = 0>
+T Sum(const Vector<T, Params...> &v) noexcept {
+	return Sum(AsSpan(v));
+}
+
+template<typename T, typename ... ParamsA, typename ... ParamsB, EnableIfArithmetic<T> = 0>
+T Dot(const Vector<T, ParamsA...> &a, const Vector<T, ParamsB...> &b) noexcept {
+	return Dot(AsSpan(a), AsSpan(b));
+}
+
+template<typename T, typename ... Params, EnableIfArithmetic<T> = 0>
+T Min(const Vector<T, Params...> &v) noexcept {
+	return Min(AsSpan(v));
+}
+
+template<typename T, typename ... Params, EnableIfArithmetic<T> = 0>
+T Max(const Vector<T, Params...> &v) noexcept {
+	return Max(AsSpan(v));
+}
+
+template<typename T, typename ... Params, EnableIfArithmetic<T> = 0>
+size_t Count(const Vector<T, Params...> &v, std::type_identity_t<T> value) noexcept {
+	return Count(AsSpan(v), value);
+}
+
+template<typename T, typename ... Params, EnableIfArithmetic<T> = 0>
+size_t Find(const Vector<T, Params...> &v, std::type_identity_t<T> value) noexcept {
+	return Find(AsSpan(v), value);
+}
+
+template<typename T, typename ... Params, EnableIfArithmetic<T> = 0>
+void Fill(Vector<T, Params...> &v, std::type_identity_t<T> value) noexcept {
+	Fill(AsSpan(v), value);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocators.h"
+#include "vector.h"
+
+// Преобразования между Vector и std::vector. std::vector не умеет ни отдавать, ни принимать свой буфер,
+// поэтому FromStdVector и ToStdVector перемещают элементы (для тривиальных типов это один memcpy).
+// Для тривиально копируемых T AdoptStdVector забирает буфер std::vector без копирования
+
+// Перемещает элементы source в новый Vector с тем же аллокатором. source остаётся пустым
+template<typename T, typename Allocator>
+Vector<T, Allocator> FromStdVector(std::vector<T, Allocator> &&source) {
+	Vector<T, Allocator> result(source.get_allocator());
+	result.Reserve(source.size());
+	result.Append(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+	source.clear();
+	return result;
+}
+
+// Перемещает элементы source в новый std::vector с тем же аллокатором. source остаётся пустым
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+std::vector<T, Allocator> ToStdVector(Vector<T, Allocator, GrowthPolicy, Instrumentation> &&source) {
+	std::vector<T, Allocator> result(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()),
+			source.GetAllocator());
+	Vector<T, Allocator, GrowthPolicy, Instrumentation> discarded(std::move(source));
+	return result;
+}
+
+// Deleter для AdoptingVector: владеет std::vector, чей буфер отдан вектору, и освобождает его
+template<typename T, typename Allocator>
+class StdVectorKeeper {
+public:
+	explicit StdVectorKeeper(std::vector<T, Allocator> &&owner) noexcept :
+			owner_(std::move(owner)) {
+	}
+
+	void operator()(T*, size_t) noexcept {
+		std::vector<T, Allocator>().swap(owner_);
+	}
+
+private:
+	std::vector<T, Allocator> owner_;
+};
+
+// Забирает буфер source без копирования. Vector сам создаёт и разрушает элементы в чужом буфере, поэтому
+// это допустимо только для тривиально копируемых T. Если выделить состояние аллокатора не удалось,
+// исключение пробрасывается, а содержимое source теряется
+template<typename T, typename Allocator>
+AdoptingVector<T, StdVectorKeeper<T, Allocator>> AdoptStdVector(std::vector<T, Allocator> &&source) {
+	static_assert(std::is_trivially_copyable_v<T>, "AdoptStdVector requires a trivially copyable element type");
+	AdoptingVector<T, StdVectorKeeper<T, Allocator>> result;
+	if (source.capacity() != 0) {
+		T *data = source.data();
+		const size_t size = source.size();
+		const size_t capacity = source.capacity();
+		result.Adopt(data, size, capacity, StdVectorKeeper<T, Allocator>(std::move(source)));
+	}
+	return result;
+}
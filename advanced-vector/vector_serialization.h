@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "vector.h"
+
+// Двоичный формат Vector: заголовок VectorWireHeader и сразу за ним полезная нагрузка.
+// Для тривиально копируемых T нагрузка — содержимое буфера как есть: Serialize отправляет заголовок
+// и буфер одним writev без промежуточного копирования, Deserialize читает элементы прямо в память нового
+// вектора. Остальные типы записываются через специализацию SerializationHooks<T> (element_size в заголовке
+// при этом равен 0). Числа хранятся в порядке байтов машины; поле magic позволяет обнаружить файл,
+// записанный с другим порядком. Заголовку Deserialize не доверяет: размер нагрузки из файла сверяется
+// с длиной файла, а из канала или сокета память выделяется по мере поступления данных
+
+struct VectorWireHeader {
+	static constexpr uint32_t kMagic = 0x56454331;  // "VEC1"
+	static constexpr uint16_t kVersion = 1;
+
+	uint32_t magic = kMagic;
+	uint16_t version = kVersion;
+	uint16_t alignment = 0;
+	uint32_t element_size = 0;
+	uint32_t reserved = 0;
+	uint64_t size = 0;
+	uint64_t payload_bytes = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<VectorWireHeader> && sizeof(VectorWireHeader) == 32);
+
+// Последовательное чтение байтов нагрузки для SerializationHooks::Read
+class ByteReader {
+public:
+	ByteReader(const char *data, size_t size) noexcept :
+			current_(data), end_(data + size) {
+	}
+
+	void Read(void *dest, size_t bytes) {
+		if (bytes > Remaining()) {
+			throw std::runtime_error("Deserialize: truncated payload");
+		}
+		std::memcpy(dest, current_, bytes);
+		current_ += bytes;
+	}
+
+	template<typename U>
+	U Read() {
+		static_assert(std::is_trivially_copyable_v<U>);
+		U value;
+		Read(&value, sizeof(U));
+		return value;
+	}
+
+	size_t Remaining() const noexcept {
+		return end_ - current_;
+	}
+
+private:
+	const char *current_;
+	const char *end_;
+};
+
+inline void WriteBytes(Vector<char> &out, const void *data, size_t bytes) {
+	const char *first = static_cast<const char*>(data);
+	out.Insert(out.end(), first, first + bytes);
+}
+
+// Сериализация нетривиального типа. Специализация должна определять
+//     static void Write(Vector<char> &out, const T &value);
+//     static T Read(ByteReader &in);
+// и может определять static constexpr size_t kMinEncodedSize — наименьшее число байт, которое Write
+// записывает для одного элемента (по умолчанию 1). По нему Deserialize ограничивает резерв под элементы
+template<typename T>
+struct SerializationHooks;
+
+template<>
+struct SerializationHooks<std::string> {
+	static constexpr size_t kMinEncodedSize = sizeof(uint64_t);
+
+	static void Write(Vector<char> &out, const std::string &value) {
+		const uint64_t length = value.size();
+		WriteBytes(out, &length, sizeof(length));
+		WriteBytes(out, value.data(), value.size());
+	}
+
+	static std::string Read(ByteReader &in) {
+		const uint64_t length = in.Read<uint64_t>();
+		if (length > in.Remaining()) {
+			throw std::runtime_error("Deserialize: truncated payload");
+		}
+		std::string value(length, '\0');
+		in.Read(value.data(), length);
+		return value;
+	}
+};
+
+namespace vector_io {
+
+template<typename T>
+constexpr size_t MinEncodedSize() noexcept {
+	if constexpr (requires { SerializationHooks<T>::kMinEncodedSize; }) {
+		return std::max<size_t>(SerializationHooks<T>::kMinEncodedSize, 1);
+	} else {
+		return 1;
+	}
+}
+
+// Передаёт все части iov, повторяя writev/readv после частичной передачи и EINTR
+template<typename Transfer>
+void TransferAll(Transfer transfer, iovec *iov, int count, const char *what) {
+	for (;;) {
+		while (count > 0 && iov->iov_len == 0) {
+			++iov;
+			--count;
+		}
+		if (count == 0) {
+			return;
+		}
+		const ssize_t done = transfer(iov, count);
+		if (done < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+		if (done == 0) {
+			throw std::runtime_error("unexpected end of stream");
+		}
+		size_t left = static_cast<size_t>(done);
+		while (left != 0) {
+			const size_t part = std::min(left, iov->iov_len);
+			iov->iov_base = static_cast<char*>(iov->iov_base) + part;
+			iov->iov_len -= part;
+			left -= part;
+			if (iov->iov_len == 0) {
+				++iov;
+				--count;
+			}
+		}
+	}
+}
+
+inline void WriteAll(int fd, iovec *iov, int count) {
+	TransferAll([fd](iovec *parts, int n) {
+		return ::writev(fd, parts, n);
+	}, iov, count, "writev");
+}
+
+inline void ReadAll(int fd, iovec *iov, int count) {
+	TransferAll([fd](iovec *parts, int n) {
+		return ::readv(fd, parts, n);
+	}, iov, count, "readv");
+}
+
+// Сколько байт осталось прочитать из обычного файла fd; для каналов, сокетов и устройств длина не известна
+inline uint64_t KnownRemainingBytes(int fd) noexcept {
+	struct stat info;
+	if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+		return UINT64_MAX;
+	}
+	const off_t position = ::lseek(fd, 0, SEEK_CUR);
+	if (position < 0 || position > info.st_size) {
+		return UINT64_MAX;
+	}
+	return static_cast<uint64_t>(info.st_size - position);
+}
+
+// Первая порция чтения из потока неизвестной длины
+inline constexpr size_t kChunkBytes = size_t(64) << 10;
+
+// Читает count элементов тривиально копируемого типа U. Если длина потока известна и вмещает нагрузку,
+// буфер выделяется сразу целиком. Иначе он удваивается по мере чтения, так что повреждённый заголовок
+// не заставляет выделить больше чем вдвое против действительно полученных данных
+template<typename U, typename Allocator>
+RawMemory<U, Allocator> ReadElements(int fd, uint64_t count, const Allocator &alloc) {
+	const uint64_t known = KnownRemainingBytes(fd);
+	if (known != UINT64_MAX) {
+		if (count > known / sizeof(U)) {
+			throw std::runtime_error("Deserialize: payload is longer than the file");
+		}
+		RawMemory<U, Allocator> buffer(count, alloc);
+		iovec iov = {buffer.GetAddress(), count * sizeof(U)};
+		ReadAll(fd, &iov, 1);
+		return buffer;
+	}
+	uint64_t capacity = std::min<uint64_t>(count, std::max<size_t>(kChunkBytes / sizeof(U), 1));
+	RawMemory<U, Allocator> buffer(capacity, alloc);
+	uint64_t done = 0;
+	for (;;) {
+		iovec iov = {buffer.GetAddress() + done, (capacity - done) * sizeof(U)};
+		ReadAll(fd, &iov, 1);
+		done = capacity;
+		if (done == count) {
+			return buffer;
+		}
+		capacity = std::min(count, done * 2);
+		RawMemory<U, Allocator> bigger(capacity, alloc);
+		std::memcpy(static_cast<void*>(bigger.GetAddress()), static_cast<const void*>(buffer.GetAddress()), done * sizeof(U));
+		buffer.Swap(bigger);
+	}
+}
+
+template<typename T>
+void CheckHeader(const VectorWireHeader &header) {
+	if (header.magic != VectorWireHeader::kMagic) {
+		throw std::runtime_error("Deserialize: bad magic or byte order");
+	}
+	if (header.version != VectorWireHeader::kVersion) {
+		throw std::runtime_error("Deserialize: unsupported version");
+	}
+	const uint32_t element_size = std::is_trivially_copyable_v<T> ? sizeof(T) : 0;
+	if (header.element_size != element_size || header.alignment != alignof(T)) {
+		throw std::runtime_error("Deserialize: element type mismatch");
+	}
+	if (element_size != 0 && (header.size > UINT64_MAX / element_size || header.payload_bytes != header.size * element_size)) {
+		throw std::runtime_error("Deserialize: inconsistent header");
+	}
+}
+
+}  // namespace vector_io
+
+// Записывает v в дескриптор fd (файл, сокет, канал)
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Serialize(int fd, const Vector<T, Allocator, GrowthPolicy, Instrumentation> &v) {
+	VectorWireHeader header;
+	header.alignment = alignof(T);
+	header.size = v.Size();
+	if constexpr (std::is_trivially_copyable_v<T>) {
+		header.element_size = sizeof(T);
+		header.payload_bytes = v.Size() * sizeof(T);
+		iovec iov[2] = {{&header, sizeof(header)}, {const_cast<T*>(v.Data()), header.payload_bytes}};
+		vector_io::WriteAll(fd, iov, 2);
+	} else {
+		Vector<char> payload;
+		for (const T &item : v) {
+			SerializationHooks<T>::Write(payload, item);
+		}
+		header.payload_bytes = payload.Size();
+		iovec iov[2] = {{&header, sizeof(header)}, {payload.Data(), payload.Size()}};
+		vector_io::WriteAll(fd, iov, 2);
+	}
+}
+
+// Читает из fd вектор, записанный Serialize
+template<typename T, typename Allocator = std::allocator<T>>
+Vector<T, Allocator> Deserialize(int fd, const Allocator &alloc = Allocator()) {
+	VectorWireHeader header;
+	iovec header_iov = {&header, sizeof(header)};
+	vector_io::ReadAll(fd, &header_iov, 1);
+	vector_io::CheckHeader<T>(header);
+	if constexpr (std::is_trivially_copyable_v<T>) {
+		RawMemory<T, Allocator> buffer = vector_io::ReadElements<T>(fd, header.size, alloc);
+		return Vector<T, Allocator>(std::move(buffer), header.size);
+	} else {
+		RawMemory<char, std::allocator<char>> payload = vector_io::ReadElements<char>(fd, header.payload_bytes,
+				std::allocator<char>());
+		ByteReader in(payload.GetAddress(), header.payload_bytes);
+		Vector<T, Allocator> result(alloc);
+		// Размер из заголовка не проверен, поэтому заранее резервируется не больше элементов, чем может
+		// поместиться в нагрузке
+		result.Reserve(std::min<uint64_t>(header.size, header.payload_bytes / vector_io::MinEncodedSize<T>()));
+		for (uint64_t i = 0; i < header.size; ++i) {
+			result.EmplaceBack(SerializationHooks<T>::Read(in));
+		}
+		if (in.Remaining() != 0) {
+			throw std::runtime_error("Deserialize: trailing bytes in payload");
+		}
+		return result;
+	}
+}
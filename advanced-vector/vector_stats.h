@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#include "vector.h"
+
+// Счётчики событий памяти для группы векторов с общим тегом
+struct VectorStats {
+	explicit constexpr VectorStats(const char *name) noexcept :
+			name(name) {
+	}
+
+	const char *name;
+	std::atomic<uint64_t> allocations { 0 };
+	std::atomic<uint64_t> bytes_allocated { 0 };
+	std::atomic<uint64_t> reallocations { 0 };
+	std::atomic<uint64_t> relocated_elements { 0 };
+	std::atomic<uint64_t> peak_size { 0 };
+	std::atomic<uint64_t> peak_capacity { 0 };
+};
+
+// Векторы в статических объектах могут писать в счётчики до конца работы программы
+static_assert(std::is_trivially_destructible_v<VectorStats>);
+
+// Реестр всех VectorStats процесса, из которого счётчики выгружаются в систему метрик
+class VectorStatsRegistry {
+public:
+	static VectorStatsRegistry& Instance() {
+		static VectorStatsRegistry registry;
+		return registry;
+	}
+
+	void Register(const VectorStats *stats) {
+		std::lock_guard lock(mutex_);
+		stats_.push_back(stats);
+	}
+
+	template<typename Visitor>
+	void ForEach(Visitor visitor) const {
+		std::lock_guard lock(mutex_);
+		for (const VectorStats *stats : stats_) {
+			visitor(*stats);
+		}
+	}
+
+	void Dump(std::ostream &out) const {
+		ForEach([&out](const VectorStats &stats) {
+			out << stats.name
+					<< " allocations=" << stats.allocations.load(std::memory_order_relaxed)
+					<< " bytes_allocated=" << stats.bytes_allocated.load(std::memory_order_relaxed)
+					<< " reallocations=" << stats.reallocations.load(std::memory_order_relaxed)
+					<< " relocated_elements=" << stats.relocated_elements.load(std::memory_order_relaxed)
+					<< " peak_size=" << stats.peak_size.load(std::memory_order_relaxed)
+					<< " peak_capacity=" << stats.peak_capacity.load(std::memory_order_relaxed) << '\n';
+		});
+	}
+
+private:
+	VectorStatsRegistry() = default;
+
+	mutable std::mutex mutex_;
+	std::vector<const VectorStats*> stats_;
+};
+
+// Политика инструментирования, накапливающая счётчики в VectorStats своего тега.
+// Tag — произвольный тип со статическим полем kName, например
+// struct ParserBuffers { static constexpr const char *kName = "parser"; };
+template<typename Tag>
+struct CountingInstrumentation {
+	static VectorStats& Stats() noexcept {
+		static_cast<void>(registered_);
+		return stats_;
+	}
+
+	static void OnAllocate(size_t bytes, size_t capacity) noexcept {
+		VectorStats &stats = Stats();
+		stats.allocations.fetch_add(1, std::memory_order_relaxed);
+		stats.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+		UpdateMax(stats.peak_capacity, capacity);
+	}
+
+	static void OnReallocate(size_t relocated) noexcept {
+		VectorStats &stats = Stats();
+		stats.reallocations.fetch_add(1, std::memory_order_relaxed);
+		stats.relocated_elements.fetch_add(relocated, std::memory_order_relaxed);
+	}
+
+	static void OnSize(size_t size, size_t capacity) noexcept {
+		VectorStats &stats = Stats();
+		UpdateMax(stats.peak_size, size);
+		UpdateMax(stats.peak_capacity, capacity);
+	}
+
+private:
+	// Счётчики инициализируются константно, а в реестр попадают при инициализации статических объектов:
+	// хуки вызываются из noexcept-функций вектора и не должны ни выделять память, ни захватывать мьютекс
+	static inline VectorStats stats_ {Tag::kName};
+	static inline const bool registered_ = (VectorStatsRegistry::Instance().Register(&stats_), true);
+
+	static void UpdateMax(std::atomic<uint64_t> &peak, uint64_t value) noexcept {
+		uint64_t current = peak.load(std::memory_order_relaxed);
+		while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+		}
+	}
+};
+
+// Vector, собирающий статистику под тегом Tag
+template<typename T, typename Tag, typename Allocator = std::allocator<T>>
+using InstrumentedVector = Vector<T, Allocator, DoublingGrowth, CountingInstrumentation<Tag>>;